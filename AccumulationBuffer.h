@@ -0,0 +1,172 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef ACCUMULATIONBUFFER_H
+#define ACCUMULATIONBUFFER_H
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include "Image.h"
+#include <gtc/packing.hpp>
+
+/*
+ * Per-texel radiance accumulator. Every add() is one pass estimate weighted by the rays behind it.
+ * Full precision mode keeps running sums; half mode keeps the running mean and squared deviation instead,
+ * because an fp16 sum stops absorbing new samples long before the bake ends.
+ */
+class AccumulationBuffer final {
+    std::vector<float>    m_sums,       m_square_sums;
+    std::vector<uint16_t> m_half_means, m_half_deviations;
+    std::vector<float>    m_weights;
+    std::vector<uint32_t> m_counts;
+    uint32_t              m_width, m_height;
+    bool                  m_half;
+
+    [[nodiscard]] float deviation(const uint32_t texel) const {
+        if (m_half) {
+            return glm::unpackHalf1x16(m_half_deviations[texel]);
+        }
+        const float mean_value = mean(texel);
+        return std::max(m_square_sums[texel] - m_weights[texel] * mean_value * mean_value, 0.0F);
+    }
+
+public:
+    AccumulationBuffer(const uint32_t width, const uint32_t height, const bool half) : m_weights(width * height, 0.0F),
+        m_counts(width * height, 0),
+        m_width(width),
+        m_height(height),
+        m_half(half) {
+        if (m_half) {
+            m_half_means.resize(m_counts.size(), 0);
+            m_half_deviations.resize(m_counts.size(), 0);
+        } else {
+            m_sums.resize(m_counts.size(), 0.0F);
+            m_square_sums.resize(m_counts.size(), 0.0F);
+        }
+    }
+
+    [[nodiscard]] uint32_t width() const {
+        return m_width;
+    }
+
+    [[nodiscard]] uint32_t height() const {
+        return m_height;
+    }
+
+    [[nodiscard]] uint32_t index(const int32_t x, const int32_t y) const {
+        return static_cast<uint32_t>(y) * m_width + static_cast<uint32_t>(x);
+    }
+
+    [[nodiscard]] bool contains(const int32_t x, const int32_t y) const {
+        return x >= 0 && y >= 0 && static_cast<uint32_t>(x) < m_width && static_cast<uint32_t>(y) < m_height;
+    }
+
+    [[nodiscard]] uint32_t count(const uint32_t texel) const {
+        return m_counts[texel];
+    }
+
+    [[nodiscard]] float mean(const uint32_t texel) const {
+        if (m_counts[texel] == 0) {
+            return 0.0F;
+        }
+        if (m_half) {
+            return glm::unpackHalf1x16(m_half_means[texel]);
+        }
+        return m_sums[texel] / m_weights[texel];
+    }
+
+    /*
+     * Variance of a single unit-weight estimate. An estimate of weight w has variance variance / w, so every term
+     * w * (value - mean)^2 of the deviation estimates the unit-weight variance and n estimates leave n - 1 of them.
+     */
+    [[nodiscard]] float variance(const uint32_t texel) const {
+        if (m_counts[texel] < 2) {
+            return 0.0F;
+        }
+        return deviation(texel) / static_cast<float>(m_counts[texel] - 1);
+    }
+
+    // Standard error of mean().
+    [[nodiscard]] float error(const uint32_t texel) const {
+        if (m_counts[texel] < 2) {
+            return FLT_MAX;
+        }
+        return std::sqrt(variance(texel) / m_weights[texel]);
+    }
+
+    void add(const uint32_t texel, const float value, const float weight = 1.0F) {
+        m_counts[texel]++;
+        const float total_weight = m_weights[texel] += weight;
+        if (m_half) {
+            const float prev_mean = glm::unpackHalf1x16(m_half_means[texel]);
+            const float new_mean  = prev_mean + (value - prev_mean) * weight / total_weight;
+            const float dev       = glm::unpackHalf1x16(m_half_deviations[texel]);
+            m_half_means[texel]      = glm::packHalf1x16(new_mean);
+            m_half_deviations[texel] = glm::packHalf1x16(dev + weight * (value - prev_mean) * (value - new_mean));
+        } else {
+            m_sums[texel] += value * weight;
+            m_square_sums[texel] += value * value * weight;
+        }
+    }
+
+    void clear() {
+        std::fill(m_weights.begin(), m_weights.end(), 0.0F);
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+        std::fill(m_sums.begin(), m_sums.end(), 0.0F);
+        std::fill(m_square_sums.begin(), m_square_sums.end(), 0.0F);
+        std::fill(m_half_means.begin(), m_half_means.end(), 0);
+        std::fill(m_half_deviations.begin(), m_half_deviations.end(), 0);
+    }
+
+    // Writes the means row by row; texels without samples come out transparent black.
+    void resolve(Image &image, const ColorEncoding encoding = ColorEncoding::Linear) const {
+        std::vector<float> row(static_cast<size_t>(m_width) * 4);
+        for (int32_t y = 0; y < static_cast<int32_t>(m_height); ++y) {
+            for (uint32_t x = 0; x < m_width; ++x) {
+                const uint32_t texel = index(static_cast<int32_t>(x), y);
+                const float    light = mean(texel);
+                row[x * 4]           = light;
+                row[x * 4 + 1]       = light;
+                row[x * 4 + 2]       = light;
+                row[x * 4 + 3]       = m_counts[texel] > 0 ? 1.0F : 0.0F;
+            }
+            image.write_span(0, y, m_width, row.data(), encoding);
+        }
+        image.flush();
+    }
+
+    // Average standard error over the texels with at least two estimates; the ones with fewer have no error yet.
+    [[nodiscard]] float mean_error() const {
+        double   sum   = 0.0;
+        uint32_t count = 0;
+        for (uint32_t texel = 0; texel < m_counts.size(); ++texel) {
+            if (m_counts[texel] >= 2) {
+                sum += error(texel);
+                count++;
+            }
+        }
+        return count ? static_cast<float>(sum / count) : 0.0F;
+    }
+
+    // Grey RGBA8 image of the standard error, full white at max_error.
+    [[nodiscard]] std::vector<uint8_t> error_image(const float max_error) const {
+        std::vector<uint8_t> image(m_counts.size() * 4, 0);
+        for (uint32_t texel = 0; texel < m_counts.size(); ++texel) {
+            if (m_counts[texel] == 0) {
+                continue;
+            }
+            const float value        = glm::clamp(error(texel) / max_error, 0.0F, 1.0F);
+            const auto  grey         = static_cast<uint8_t>(value * UINT8_MAX);
+            image[texel * 4]         = grey;
+            image[texel * 4 + 1]     = grey;
+            image[texel * 4 + 2]     = grey;
+            image[texel * 4 + 3]     = UINT8_MAX;
+        }
+        return image;
+    }
+};
+
+#endif //ACCUMULATIONBUFFER_H
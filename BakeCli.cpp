@@ -0,0 +1,260 @@
+//
+// Created on 17.10.2026.
+//
+
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+#include "MeshLoader.h"
+#include "Scene.h"
+
+#define DEFAULT_SAMPLES_NUM  256
+#define DEFAULT_LIGHT_DIR    0.5F, -1.0F, -1.0F
+
+static void print_usage(const char *program) {
+    std::cerr << "Usage: " << program << " <mesh.bin> <lightmap.png> [options]\n"
+              << "  --size <n>             lightmap width and height (default " << LIGHTMAP_SIZE << ")\n"
+              << "  --samples <n>          rays per texel (default " << DEFAULT_SAMPLES_NUM << ")\n"
+              << "  --light <x> <y> <z>    sun direction (default 0.5 -1 -1)\n"
+              << "  --threads <n>          worker threads, 0 for all cores\n"
+              << "  --seed <n>             bake seed\n"
+              << "  --sampler <name>       random | sobol | halton | bluenoise\n"
+              << "  --variance <file.png>  also write the standard error map\n"
+              << "  --srgb                 store the lightmap sRGB encoded\n"
+              << "  --bvh-quality <name>   low | medium | high\n"
+              << "  --bvh-compact          smaller BVH, slower traversal\n"
+              << "  --bvh-robust           watertight BVH traversal\n"
+              << "  --serial-bvh-build     build the BVH on Embree's threads before patch generation\n"
+              << "  --embree-threads <n>   Embree's BVH build threads with --serial-bvh-build, 0 for all cores\n"
+              << "  --embree-isa <name>    sse4.2 | avx | avx2 | avx512\n"
+              << "  --benchmark            compare patch orders, AO ray binning and BVH settings\n";
+}
+
+template<typename T>
+static bool parse_value(const char *text, T &value) {
+    const char *end = text + std::strlen(text);
+    return std::from_chars(text, end, value).ptr == end;
+}
+
+static double rays_per_second(const BakeStats &stats, const double seconds) {
+    return static_cast<double>(stats.ao_rays + stats.shadow_rays) / std::max(seconds, 1e-9);
+}
+
+// Times Scene::bake() alone; patch setup and BVH builds are excluded.
+static double timed_bake(Scene &scene) {
+    const auto start = std::chrono::steady_clock::now();
+    scene.bake();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double megabytes(const int64_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+static void benchmark(const glm::vec3 &light_direction, const MeshData &mesh, const int32_t samples,
+                      const BakeConfig &config, const uint32_t size) {
+    // Every variant runs on the structure-of-arrays PatchStore; only the patch order and AO binning change.
+    struct Variant final {
+        const char *name;
+        bool        morton_order;
+        bool        ray_binning;
+    };
+    for (const auto &[name, morton_order, ray_binning]: {
+             Variant{"soa, triangle order ", false, false},
+             Variant{"soa, morton order   ", true, false},
+             Variant{"soa, morton + bins  ", true, true},
+         }) {
+        BakeConfig variant_config   = config;
+        variant_config.morton_order = morton_order;
+        variant_config.ray_binning  = ray_binning;
+
+        Scene        scene(light_direction, &mesh, samples, variant_config, size, size);
+        const double seconds = timed_bake(scene);
+        std::cout << name << seconds << " s, " << rays_per_second(scene.stats, seconds) / 1e6 << " Mrays/s"
+                  << std::endl;
+    }
+
+    struct BvhVariant final {
+        const char *name;
+        BvhQuality  quality;
+        bool        compact;
+        bool        robust;
+        bool        cooperative;
+    };
+    for (const auto &[name, quality, compact, robust, cooperative]: {
+             BvhVariant{"bvh low             ", BvhQuality::Low, false, false, true},
+             BvhVariant{"bvh medium          ", BvhQuality::Medium, false, false, true},
+             BvhVariant{"bvh high            ", BvhQuality::High, false, false, true},
+             BvhVariant{"bvh medium compact  ", BvhQuality::Medium, true, false, true},
+             BvhVariant{"bvh medium robust   ", BvhQuality::Medium, false, true, true},
+             BvhVariant{"bvh medium, serial  ", BvhQuality::Medium, false, false, false},
+         }) {
+        BakeConfig variant_config            = config;
+        variant_config.bvh_quality           = quality;
+        variant_config.bvh_compact           = compact;
+        variant_config.bvh_robust            = robust;
+        variant_config.cooperative_bvh_build = cooperative;
+
+        Scene        scene(light_direction, &mesh, samples, variant_config, size, size);
+        const double seconds = timed_bake(scene);
+        const auto & stats   = scene.stats;
+        std::cout << name << "build " << stats.bvh_build_seconds << " s, " << megabytes(stats.bvh_bytes) << " MB ("
+                  << megabytes(stats.bvh_peak_bytes) << " MB peak), bake " << seconds << " s, "
+                  << rays_per_second(stats, seconds) / 1e6 << " Mrays/s" << std::endl;
+    }
+
+    /*
+     * How fast each sampler drives texels below the adaptive error threshold: the passes and rays spent before the
+     * bake stops, and the error the remaining estimates end at. Adaptive sampling is forced on for the comparison.
+     */
+    struct SamplerVariant final {
+        const char *name;
+        SamplerType type;
+    };
+    for (const auto &[name, type]: {
+             SamplerVariant{"sampler random      ", SamplerType::Random},
+             SamplerVariant{"sampler sobol       ", SamplerType::Sobol},
+             SamplerVariant{"sampler halton      ", SamplerType::Halton},
+             SamplerVariant{"sampler bluenoise   ", SamplerType::BlueNoise},
+         }) {
+        BakeConfig variant_config        = config;
+        variant_config.sampler           = type;
+        variant_config.adaptive_sampling = true;
+
+        Scene        scene(light_direction, &mesh, samples, variant_config, size, size);
+        const double seconds = timed_bake(scene);
+        const auto & stats   = scene.stats;
+        std::cout << name << stats.passes << " passes, " << stats.ao_rays + stats.shadow_rays << " rays, "
+                  << stats.converged << " converged, mean error " << stats.mean_error << ", bake " << seconds
+                  << " s" << std::endl;
+    }
+}
+
+static bool parse_sampler(const std::string_view name, SamplerType &type) {
+    if (name == "random") type = SamplerType::Random;
+    else if (name == "sobol") type = SamplerType::Sobol;
+    else if (name == "halton") type = SamplerType::Halton;
+    else if (name == "bluenoise") type = SamplerType::BlueNoise;
+    else return false;
+    return true;
+}
+
+static bool parse_bvh_quality(const std::string_view name, BvhQuality &quality) {
+    if (name == "low") quality = BvhQuality::Low;
+    else if (name == "medium") quality = BvhQuality::Medium;
+    else if (name == "high") quality = BvhQuality::High;
+    else return false;
+    return true;
+}
+
+int main(const int argc, char **argv) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const std::string mesh_file_name     = argv[1];
+    const std::string lightmap_file_name = argv[2];
+    std::string       variance_file_name;
+    bool              run_benchmark = false;
+
+    BakeConfig config;
+    uint32_t   size            = LIGHTMAP_SIZE;
+    int32_t    samples         = DEFAULT_SAMPLES_NUM;
+    glm::vec3  light_direction = {DEFAULT_LIGHT_DIR};
+
+    for (int32_t i = 3; i < argc; ++i) {
+        const std::string_view option    = argv[i];
+        const int32_t          remaining = argc - i - 1;
+
+        bool parsed = false;
+        if (option == "--size" && remaining >= 1) {
+            parsed = parse_value(argv[++i], size) && size > 0;
+        } else if (option == "--samples" && remaining >= 1) {
+            parsed = parse_value(argv[++i], samples) && samples > 0;
+        } else if (option == "--light" && remaining >= 3) {
+            parsed = parse_value(argv[i + 1], light_direction.x) &&
+                     parse_value(argv[i + 2], light_direction.y) &&
+                     parse_value(argv[i + 3], light_direction.z);
+            i += 3;
+        } else if (option == "--threads" && remaining >= 1) {
+            parsed = parse_value(argv[++i], config.thread_count);
+        } else if (option == "--seed" && remaining >= 1) {
+            parsed = parse_value(argv[++i], config.seed);
+        } else if (option == "--sampler" && remaining >= 1) {
+            parsed = parse_sampler(argv[++i], config.sampler);
+        } else if (option == "--bvh-quality" && remaining >= 1) {
+            parsed = parse_bvh_quality(argv[++i], config.bvh_quality);
+        } else if (option == "--bvh-compact") {
+            config.bvh_compact = true;
+            parsed             = true;
+        } else if (option == "--bvh-robust") {
+            config.bvh_robust = true;
+            parsed            = true;
+        } else if (option == "--serial-bvh-build") {
+            config.cooperative_bvh_build = false;
+            parsed                       = true;
+        } else if (option == "--embree-threads" && remaining >= 1) {
+            parsed = parse_value(argv[++i], config.embree_threads);
+        } else if (option == "--embree-isa" && remaining >= 1) {
+            config.embree_isa = argv[++i];
+            parsed            = true;
+        } else if (option == "--srgb") {
+            config.srgb_output = true;
+            parsed             = true;
+        } else if (option == "--benchmark") {
+            run_benchmark = true;
+            parsed        = true;
+        } else if (option == "--variance" && remaining >= 1) {
+            variance_file_name = argv[++i];
+            parsed             = true;
+        }
+
+        if (!parsed) {
+            std::cerr << "Invalid option: " << option << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    const auto mesh = load_mesh(mesh_file_name);
+    if (!mesh) {
+        return 1;
+    }
+
+    if (run_benchmark) {
+        benchmark(light_direction, *mesh, samples, config, size);
+        return 0;
+    }
+
+    const auto   startup_start = std::chrono::steady_clock::now();
+    Scene        scene(light_direction, mesh.get(), samples, config, size, size);
+    const double startup_seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - startup_start).count();
+    const double seconds = timed_bake(scene);
+
+    if (!scene.lightmap.save(lightmap_file_name)) {
+        std::cerr << "Error writing file: " << lightmap_file_name << std::endl;
+        return 1;
+    }
+    if (!variance_file_name.empty()) {
+        scene.save_variance_map(variance_file_name);
+    }
+
+    const auto &stats = scene.stats;
+    std::cout << "Baked " << mesh->triangle_count() << " triangles into " << size << "x" << size << " texels: "
+              << stats.passes << " passes, " << stats.converged << " converged, "
+              << stats.ao_rays << " AO rays, " << stats.shadow_rays << " shadow rays, "
+              << stats.ao_free_patches << " AO-free patches, " << stats.shadow_resolved << " shadow-resolved patches, "
+              << stats.shadow_cache_hits << " shadow cache hits, "
+              << stats.duplicate_patches << " duplicate patches, " << stats.conflict_texels << " conflicting texels, "
+              << megabytes(stats.bvh_bytes) << " MB BVH built in " << stats.bvh_build_seconds << " s, "
+              << static_cast<double>(stats.triangle_store_bytes) / mesh->triangle_count()
+              << " bytes per triangle of setup, "
+              << startup_seconds << " s startup, "
+              << seconds << " s, " << rays_per_second(stats, seconds) / 1e6 << " Mrays/s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,75 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef BAKECONFIG_H
+#define BAKECONFIG_H
+#include <cstdint>
+#include <string>
+
+#include "Sampler.h"
+
+#define BAKE_TILE_SIZE            256
+#define ADAPTIVE_MIN_PASSES       3
+#define ADAPTIVE_MAX_RAY_SCALE    4
+#define ADAPTIVE_ERROR_THRESHOLD  0.002F
+
+enum class BvhQuality : uint8_t {
+    Low,    // fastest build, slowest traversal
+    Medium, // Embree's default
+    High    // spatial splits: slowest build, fastest traversal
+};
+
+struct BakeConfig final {
+    uint32_t thread_count = 0; // 0 picks std::thread::hardware_concurrency()
+    uint32_t tile_size    = BAKE_TILE_SIZE;
+
+    SamplerType sampler = SamplerType::Sobol;
+    uint32_t    seed    = 0; // same seed, same lightmap, whatever the thread count
+
+    bool half_accumulation   = false; // fp16 running means instead of fp32 sums
+    bool conservative_raster = true;  // patch every texel a triangle overlaps, not only covered centres
+    bool texel_ownership     = true;  // bake one patch per texel and drop the duplicates from shared edges
+    bool morton_order        = true;  // store patches along a Morton curve of their positions for BVH coherence
+    bool shadow_cache        = true;  // test the chart's last sun occluder before a BVH traversal
+    bool ray_binning         = true;  // sort a tile's AO rays by direction octant and origin before tracing
+    bool ao_culling          = true;  // skip AO rays for texels with no geometry above them within AO_RADIUS
+    bool shadow_blocks       = true;  // skip shadow rays inside blocks whose lattice corners are all lit or all in umbra
+
+    bool     adaptive_sampling        = true;
+    uint32_t adaptive_min_passes      = ADAPTIVE_MIN_PASSES;
+    uint32_t adaptive_max_ray_scale   = ADAPTIVE_MAX_RAY_SCALE;
+    float    adaptive_error_threshold = ADAPTIVE_ERROR_THRESHOLD; // standard error at which a texel stops sampling
+
+    uint32_t dilation_radius      = 0;    // texels to grow charts into the gutter, 0 fills every empty texel
+    bool     chart_aware_dilation = true; // gutter texels only take values from the chart nearest to them
+
+    bool srgb_output = false; // store the lightmap sRGB encoded, spending more of the 8 bits on dark texels
+
+    BvhQuality  bvh_quality           = BvhQuality::Medium;
+    bool        bvh_compact           = false; // smaller BVH nodes at some cost in traversal speed
+    bool        bvh_robust            = false; // watertight traversal: no rays slipping through shared edges
+    bool        triangle_feature_mask = true;  // declare that queries only ever meet triangles
+    bool        cooperative_bvh_build = true;  // build the BVH on the bake's pool, overlapped with patch generation
+    uint32_t    embree_threads        = 0;     // Embree's own build threads without a cooperative build, 0 for all
+    std::string embree_isa;                    // sse4.2, avx, avx2 or avx512; empty picks the best the CPU has
+};
+
+struct BakeStats final {
+    uint64_t ao_rays              = 0;
+    uint64_t shadow_rays          = 0;
+    uint64_t shadow_cache_hits    = 0;
+    uint32_t ao_free_patches      = 0;
+    uint32_t shadow_resolved      = 0;
+    uint32_t passes               = 0;
+    uint32_t converged            = 0;
+    float    mean_error           = 0.0F; // standard error of the final estimates, averaged over the baked texels
+    uint32_t duplicate_patches    = 0; // patches that lost their texel to another one
+    uint32_t conflict_texels      = 0; // texels claimed by more than one chart
+    int64_t  bvh_bytes            = 0; // held by the Embree device after the scene build
+    int64_t  bvh_peak_bytes       = 0; // including the build's temporary memory
+    double   bvh_build_seconds    = 0.0; // from queueing the commit until the BVH is ready
+    size_t   triangle_store_bytes = 0; // peak size of the per-triangle setup, freed before the bake
+};
+
+#endif //BAKECONFIG_H
@@ -0,0 +1,265 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef IMAGE_H
+#define IMAGE_H
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ThirdParty/lodepng.h"
+#include <glm.hpp>
+
+#define COLOR_BLACK 0
+#define COLOR_WHITE 255
+
+#define SRGB_LUT_SIZE 4096
+
+enum class ImageBuffering : uint8_t {
+    Double, // writes land in a back buffer and show up after flush()
+    Single  // writes are visible at once; for images that are loaded and then only read
+};
+
+enum class ColorEncoding : uint8_t {
+    Linear,
+    Srgb // colour channels go through the sRGB transfer curve, alpha stays linear
+};
+
+/*
+ * CPU-side RGBA8 image. Double buffered images keep writes in a back buffer until flush(), so a filter pass can
+ * read its neighbours while writing results. Written rows are tracked, and flush() copies and reports only those.
+ */
+class Image final {
+    std::vector<uint8_t> m_buffer, m_temp_buffer;
+    std::vector<uint8_t> m_dirty_rows;
+    uint32_t             m_width,  m_height;
+    ImageBuffering       m_buffering;
+
+    [[nodiscard]] std::vector<uint8_t> &back_buffer() {
+        return m_buffering == ImageBuffering::Double ? m_temp_buffer : m_buffer;
+    }
+
+    static uint8_t rgbau8(const float value) {
+        return static_cast<uint8_t>(value * UINT8_MAX);
+    }
+
+    static float rgbaf(const uint8_t value) {
+        return static_cast<float>(value) / UINT8_MAX;
+    }
+
+    // Linear [0, 1] to 8-bit sRGB, indexed by value * (SRGB_LUT_SIZE - 1).
+    static const std::array<uint8_t, SRGB_LUT_SIZE> &srgb_lut() {
+        static const std::array<uint8_t, SRGB_LUT_SIZE> lut = [] {
+            std::array<uint8_t, SRGB_LUT_SIZE> table{};
+            for (uint32_t i = 0; i < SRGB_LUT_SIZE; ++i) {
+                const float linear = static_cast<float>(i) / (SRGB_LUT_SIZE - 1);
+                const float srgb   = linear <= 0.0031308F
+                                         ? linear * 12.92F
+                                         : 1.055F * std::pow(linear, 1.0F / 2.4F) - 0.055F;
+                table[i] = static_cast<uint8_t>(srgb * UINT8_MAX + 0.5F);
+            }
+            return table;
+        }();
+        return lut;
+    }
+
+    // Plain loops over a flat channel array, so the compiler emits packed min/max/mul/convert.
+    static void encode_linear(const float *values, uint8_t *bytes, const uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            bytes[i] = static_cast<uint8_t>(std::clamp(values[i], 0.0F, 1.0F) * UINT8_MAX);
+        }
+    }
+
+    static void encode_srgb(const float *rgba, uint8_t *bytes, const uint32_t texels) {
+        const auto &lut = srgb_lut();
+        for (uint32_t i = 0; i < texels * 4; ++i) {
+            const float value = std::clamp(rgba[i], 0.0F, 1.0F);
+            bytes[i]          = i % 4 == 3
+                                    ? static_cast<uint8_t>(value * UINT8_MAX)
+                                    : lut[static_cast<uint32_t>(value * (SRGB_LUT_SIZE - 1) + 0.5F)];
+        }
+    }
+
+    static void decode_linear(const uint8_t *bytes, float *values, const uint32_t count) {
+        constexpr float scale = 1.0F / UINT8_MAX;
+        for (uint32_t i = 0; i < count; ++i) {
+            values[i] = static_cast<float>(bytes[i]) * scale;
+        }
+    }
+
+public:
+    Image(
+        const uint32_t       width,
+        const uint32_t       height,
+        const uint8_t        default_val = COLOR_BLACK,
+        const ImageBuffering buffering   = ImageBuffering::Double) : m_buffer(width * height * 4, default_val),
+                                                                     m_dirty_rows(height, 0),
+                                                                     m_width(width),
+                                                                     m_height(height),
+                                                                     m_buffering(buffering) {
+        if (m_buffering == ImageBuffering::Double) {
+            m_temp_buffer = m_buffer;
+        }
+    }
+
+    // Replaces the whole image and marks every row dirty.
+    void assign(std::vector<uint8_t> buffer, const uint32_t width, const uint32_t height) {
+        m_width  = width;
+        m_height = height;
+        if (m_buffering == ImageBuffering::Double) {
+            m_temp_buffer = buffer;
+        }
+        m_buffer = std::move(buffer);
+        m_dirty_rows.assign(height, 1);
+    }
+
+    [[nodiscard]] bool try_get_pixel_index(const int32_t x, const int32_t y, uint32_t &index) const {
+        if (x < 0 || y < 0 || static_cast<uint32_t>(x) >= m_width || static_cast<uint32_t>(y) >= m_height) {
+            return false;
+        }
+        index = (y * m_width + x) * 4;
+        return true;
+    }
+
+    [[nodiscard]] uint32_t width() const {
+        return m_width;
+    }
+
+    [[nodiscard]] uint32_t height() const {
+        return m_height;
+    }
+
+    [[nodiscard]] const std::vector<uint8_t> &buffer() const {
+        return m_buffer;
+    }
+
+    [[nodiscard]] const uint8_t *data(const int32_t x, const int32_t y) const {
+        uint32_t index;
+        return try_get_pixel_index(x, y, index) ? &m_buffer[index] : nullptr;
+    }
+
+    bool get_pixel(
+        const int32_t x,
+        const int32_t y,
+        glm::vec4 &   color) const {
+        if (uint32_t index; try_get_pixel_index(x, y, index)) {
+            color.r = rgbaf(m_buffer[index]);
+            color.g = rgbaf(m_buffer[index + 1]);
+            color.b = rgbaf(m_buffer[index + 2]);
+            color.a = rgbaf(m_buffer[index + 3]);
+            return true;
+        }
+        return false;
+    }
+
+    bool set_pixel(
+        const int32_t    x,
+        const int32_t    y,
+        const glm::vec4 &color) {
+        if (uint32_t index; try_get_pixel_index(x, y, index)) {
+            auto &back      = back_buffer();
+            back[index]     = rgbau8(color.r);
+            back[index + 1] = rgbau8(color.g);
+            back[index + 2] = rgbau8(color.b);
+            back[index + 3] = rgbau8(color.a);
+            m_dirty_rows[y] = 1;
+            return true;
+        }
+        return false;
+    }
+
+    /*
+     * Writes count texels starting at (x, y) from interleaved RGBA floats, clamped to [0, 1]. The span has to lie
+     * within one row; it is converted in bulk rather than one channel at a time.
+     */
+    void write_span(
+        const int32_t       x,
+        const int32_t       y,
+        const uint32_t      count,
+        const float *       rgba,
+        const ColorEncoding encoding = ColorEncoding::Linear) {
+        if (x < 0 || y < 0 || static_cast<uint32_t>(x) + count > m_width || static_cast<uint32_t>(y) >= m_height) {
+            return;
+        }
+        uint8_t *bytes = &back_buffer()[(static_cast<size_t>(y) * m_width + x) * 4];
+        if (encoding == ColorEncoding::Srgb) {
+            encode_srgb(rgba, bytes, count);
+        } else {
+            encode_linear(rgba, bytes, count * 4);
+        }
+        m_dirty_rows[y] = 1;
+    }
+
+    // Reads count published texels starting at (x, y) into interleaved RGBA floats.
+    void read_span(const int32_t x, const int32_t y, const uint32_t count, float *rgba) const {
+        if (x < 0 || y < 0 || static_cast<uint32_t>(x) + count > m_width || static_cast<uint32_t>(y) >= m_height) {
+            return;
+        }
+        decode_linear(&m_buffer[(static_cast<size_t>(y) * m_width + x) * 4], rgba, count * 4);
+    }
+
+    // Publishes the rows written since the last flush and calls on_rows(first_row, row_count) per dirty run.
+    template<typename Fn>
+    void flush(const Fn &on_rows) {
+        const size_t row_bytes = static_cast<size_t>(m_width) * 4;
+        for (uint32_t y = 0; y < m_height;) {
+            if (!m_dirty_rows[y]) {
+                ++y;
+                continue;
+            }
+            const uint32_t first = y;
+            while (y < m_height && m_dirty_rows[y]) {
+                m_dirty_rows[y++] = 0;
+            }
+            if (m_buffering == ImageBuffering::Double) {
+                std::memcpy(&m_buffer[first * row_bytes], &m_temp_buffer[first * row_bytes], (y - first) * row_bytes);
+            }
+            on_rows(first, y - first);
+        }
+    }
+
+    void flush() {
+        flush([](uint32_t, uint32_t) {
+        });
+    }
+
+    bool load(const std::string &file_name) {
+        std::vector<uint8_t> buffer;
+        uint32_t             width, height;
+        if (lodepng::decode(buffer, width, height, file_name) != 0) {
+            return false;
+        }
+        assign(std::move(buffer), width, height);
+        return true;
+    }
+
+    [[nodiscard]] bool save(const std::string &file_name) const {
+        return lodepng::encode(file_name, m_buffer, m_width, m_height) == 0;
+    }
+
+    [[nodiscard]] glm::vec2 to_uv_coords(const int32_t x, const int32_t y) const {
+        return {
+            (static_cast<float>(x) + 0.5F) / static_cast<float>(m_width),
+            (static_cast<float>(y) + 0.5F) / static_cast<float>(m_height)
+        };
+    }
+
+    [[nodiscard]] glm::ivec2 to_pixel_coords(const glm::vec2 &st) const {
+        return {
+            static_cast<int32_t>(st.s * static_cast<float>(m_width)),
+            static_cast<int32_t>(st.t * static_cast<float>(m_height))
+        };
+    }
+
+    Image &operator=(const std::vector<uint8_t> &buffer) {
+        assign(buffer, m_width, m_height);
+        return *this;
+    }
+};
+
+#endif //IMAGE_H
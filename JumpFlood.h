@@ -0,0 +1,79 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef JUMPFLOOD_H
+#define JUMPFLOOD_H
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "ThreadPool.h"
+
+#define JUMP_FLOOD_ROW_GRAIN 16
+#define JUMP_FLOOD_NONE      UINT32_MAX
+
+/*
+ * Jump flooding (Rong & Tan 2006): finds the nearest seed texel of every texel in O(log n) passes.
+ * Each pass looks at the eight neighbours at the current step, halving the step from half the image
+ * size down to one, then runs one more step-one pass that fixes most of the texels plain JFA gets wrong.
+ * Rows of a pass run in parallel and read from the other ping-pong buffer, so there is no shared state.
+ */
+inline std::vector<uint32_t> jump_flood(
+    const std::vector<uint8_t> &seeds,
+    const uint32_t              width,
+    const uint32_t              height,
+    ThreadPool &                pool) {
+    std::vector<uint32_t> nearest(seeds.size()), next(seeds.size());
+    for (uint32_t texel = 0; texel < seeds.size(); ++texel) {
+        nearest[texel] = seeds[texel] ? texel : JUMP_FLOOD_NONE;
+    }
+
+    const auto distance_sq = [width](const uint32_t a, const uint32_t b) {
+        const int64_t dx = static_cast<int64_t>(a % width) - static_cast<int64_t>(b % width);
+        const int64_t dy = static_cast<int64_t>(a / width) - static_cast<int64_t>(b / width);
+        return dx * dx + dy * dy;
+    };
+
+    std::vector<int32_t> steps;
+    for (uint32_t step = std::max(width, height) / 2; step > 0; step /= 2) {
+        steps.push_back(static_cast<int32_t>(step));
+    }
+    steps.push_back(1);
+
+    for (const int32_t step: steps) {
+        pool.parallel_for(height, JUMP_FLOOD_ROW_GRAIN, [&](const uint32_t begin, const uint32_t end, uint32_t) {
+            for (uint32_t y = begin; y < end; ++y) {
+                for (uint32_t x = 0; x < width; ++x) {
+                    const uint32_t texel         = y * width + x;
+                    uint32_t       best          = nearest[texel];
+                    int64_t        best_distance = best == JUMP_FLOOD_NONE ? INT64_MAX : distance_sq(texel, best);
+                    for (int32_t dy = -step; dy <= step; dy += step) {
+                        for (int32_t dx = -step; dx <= step; dx += step) {
+                            const int64_t nx = static_cast<int64_t>(x) + dx;
+                            const int64_t ny = static_cast<int64_t>(y) + dy;
+                            if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= width || ny >= height) {
+                                continue;
+                            }
+                            const uint32_t candidate = nearest[ny * width + nx];
+                            if (candidate == JUMP_FLOOD_NONE) {
+                                continue;
+                            }
+                            // Ties go to the lower texel index so the result doesn't depend on scan order.
+                            if (const int64_t distance = distance_sq(texel, candidate);
+                                distance < best_distance || (distance == best_distance && candidate < best)) {
+                                best          = candidate;
+                                best_distance = distance;
+                            }
+                        }
+                    }
+                    next[texel] = best;
+                }
+            }
+        });
+        nearest.swap(next);
+    }
+    return nearest;
+}
+
+#endif //JUMPFLOOD_H
@@ -0,0 +1,71 @@
+//
+// Created on 17.10.2026.
+//
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+MappedFile::MappedFile(const std::string &file_name) {
+    m_file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        return;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+        return;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        return;
+    }
+    m_data = static_cast<const uint8_t *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    m_size = m_data ? static_cast<size_t>(size.QuadPart) : 0;
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+    }
+}
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &file_name) {
+    const int32_t fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    // The mapping keeps its own reference to the file, so the descriptor can be closed right away.
+    if (struct stat status{}; fstat(fd, &status) == 0 && status.st_size > 0) {
+        if (void *data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0); data != MAP_FAILED) {
+            madvise(data, status.st_size, MADV_WILLNEED);
+            m_data = static_cast<const uint8_t *>(data);
+            m_size = static_cast<size_t>(status.st_size);
+        }
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        munmap(const_cast<uint8_t *>(m_data), m_size);
+    }
+}
+#endif
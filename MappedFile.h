@@ -0,0 +1,40 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only view of a whole file mapped into memory; pages are loaded on first touch and unmapped on destruction.
+class MappedFile final {
+    const uint8_t *m_data = nullptr;
+    size_t         m_size = 0;
+#ifdef _WIN32
+    void *m_file    = nullptr;
+    void *m_mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const std::string &file_name);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &)            = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    [[nodiscard]] bool is_open() const {
+        return m_data != nullptr;
+    }
+
+    [[nodiscard]] const uint8_t *data() const {
+        return m_data;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return m_size;
+    }
+};
+
+#endif //MAPPEDFILE_H
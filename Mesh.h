@@ -4,82 +4,76 @@
 
 #ifndef MESH_H
 #define MESH_H
-#include <vector>
+#include <span>
 
+#include "MeshData.h"
 #include "TucanGL.h"
 
 #define GL_VERTEX_ATTRIB_ARRAY           0
 #define GL_TEXTURE_COORD_ATTRIB_ARRAY    1
+#define GL_LIGHTMAP_COORD_ATTRIB_ARRAY   2
 
+// GL buffers for drawing a MeshData; the bake itself only needs the MeshData.
 class Mesh final {
-    std::vector<float>    m_vertices;
-    std::vector<float>    m_uvs;
-    std::vector<uint32_t> m_indices;
-    VAO *                 m_vertex_array;
-    VBO *                 m_vertex_buffer;
-    VBO *                 m_uv_buffer;
-    EBO *                 m_index_buffer;
-    glm::vec3             m_min{FLT_MAX}, m_max{FLT_MIN};
+    VAO *    m_vertex_array;
+    VBO *    m_vertex_buffer;
+    VBO *    m_uv_buffer;
+    VBO *    m_lightmap_uv_buffer;
+    EBO *    m_index_buffer;
+    uint32_t m_index_count = 0;
 
 public:
-    Mesh() {
+    explicit Mesh(const MeshData &data) {
         m_vertex_array = new VAO();
         m_vertex_array->bind();
         m_vertex_buffer = new VBO();
-        m_uv_buffer     = new VBO();
-        m_index_buffer  = new EBO();
+        m_uv_buffer          = new VBO();
+        m_lightmap_uv_buffer = new VBO();
+        m_index_buffer       = new EBO();
+
+        set_vertices(data.vertices);
+        set_tex_coords(data.uvs);
+        set_lightmap_coords(data.lightmap_uvs);
+        set_indices(data.indices);
     }
 
     ~Mesh() {
         m_vertex_array->bind();
         delete m_vertex_buffer;
         delete m_uv_buffer;
+        delete m_lightmap_uv_buffer;
         delete m_index_buffer;
         delete m_vertex_array;
     }
 
-    const std::vector<float> &   vertices = m_vertices;
-    const std::vector<float> &   uvs      = m_uvs;
-    const std::vector<uint32_t> &indices  = m_indices;
-
-    const glm::vec3 &min = m_min;
-    const glm::vec3 &max = m_max;
-
     [[nodiscard]] VAO *get_vertex_array() const {
         return m_vertex_array;
     }
 
-    void set_vertices(const std::vector<float> &vertices) {
-        m_vertices = vertices;
+    void set_vertices(const std::span<const float> vertices) const {
         m_vertex_array->bind();
         if (m_vertex_buffer->store(vertices.data(), static_cast<int32_t>(vertices.size()))) {
             glVertexAttribPointer(GL_VERTEX_ATTRIB_ARRAY, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
         }
-        for (int32_t vi = 0; vi < vertices.size(); vi += 3) {
-            const float &x = vertices[vi];
-            const float &y = vertices[vi + 1];
-            const float &z = vertices[vi + 2];
-
-            m_min.x = std::min(x, m_min.x);
-            m_min.y = std::min(y, m_min.y);
-            m_min.z = std::min(z, m_min.z);
-
-            m_max.x = std::max(x, m_max.x);
-            m_max.y = std::max(y, m_max.y);
-            m_max.z = std::max(z, m_max.z);
-        }
     }
 
-    void set_tex_coords(const std::vector<float> &uvs) {
-        m_uvs = uvs;
+    void set_tex_coords(const std::span<const float> uvs) const {
         m_vertex_array->bind();
         if (m_uv_buffer->store(uvs.data(), static_cast<int32_t>(uvs.size()))) {
             glVertexAttribPointer(GL_TEXTURE_COORD_ATTRIB_ARRAY, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
         }
     }
 
-    void set_indices(const std::vector<uint32_t> &indices) {
-        m_indices = indices;
+    // The UV set the baked lightmap is laid out in; the same data as the tex coords when the mesh has no own set.
+    void set_lightmap_coords(const std::span<const float> uvs) const {
+        m_vertex_array->bind();
+        if (m_lightmap_uv_buffer->store(uvs.data(), static_cast<int32_t>(uvs.size()))) {
+            glVertexAttribPointer(GL_LIGHTMAP_COORD_ATTRIB_ARRAY, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+        }
+    }
+
+    void set_indices(const std::span<const uint32_t> indices) {
+        m_index_count = static_cast<uint32_t>(indices.size());
         m_vertex_array->bind();
         m_index_buffer->store(indices.data(), static_cast<int32_t>(indices.size()));
     }
@@ -89,11 +83,13 @@ public:
 
         glEnableVertexAttribArray(0);
         glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
 
-        glDrawElements(GL_TRIANGLES, static_cast<int32_t>(indices.size()), GL_UNSIGNED_INT, nullptr);
+        glDrawElements(GL_TRIANGLES, static_cast<int32_t>(m_index_count), GL_UNSIGNED_INT, nullptr);
 
         glDisableVertexAttribArray(0);
         glDisableVertexAttribArray(1);
+        glDisableVertexAttribArray(2);
 
         glBindVertexArray(0);
     }
@@ -0,0 +1,88 @@
+//
+// Created on 17.10.2026.
+//
+
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "MeshLoader.h"
+
+static void print_usage(const char *program) {
+    std::cerr << "Usage: " << program << " <input.bin> <output.bin> [options]\n"
+              << "  --normals    add area-weighted vertex normals if the input has none\n";
+}
+
+// Sums the unnormalised face normals around every vertex, which weights each face by its area.
+static std::vector<float> vertex_normals(const MeshData &mesh) {
+    const auto &vertices = mesh.vertices;
+    const auto &indices  = mesh.indices;
+    const auto  position = [&vertices](const uint32_t vertex) {
+        return glm::vec3{vertices[vertex * 3], vertices[vertex * 3 + 1], vertices[vertex * 3 + 2]};
+    };
+
+    std::vector<glm::vec3> sums(mesh.vertex_count(), glm::vec3(0.0F));
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const glm::vec3 a    = position(indices[i]);
+        const glm::vec3 face = cross(position(indices[i + 1]) - a, position(indices[i + 2]) - a);
+        sums[indices[i]] += face;
+        sums[indices[i + 1]] += face;
+        sums[indices[i + 2]] += face;
+    }
+
+    std::vector<float> normals;
+    normals.reserve(sums.size() * 3);
+    for (const glm::vec3 &sum: sums) {
+        const float     length = glm::length(sum);
+        const glm::vec3 normal = length > 0.0F ? sum / length : glm::vec3(0.0F, 1.0F, 0.0F);
+        normals.insert(normals.end(), {normal.x, normal.y, normal.z});
+    }
+    return normals;
+}
+
+int main(const int argc, char **argv) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    bool add_normals = false;
+    for (int32_t i = 3; i < argc; ++i) {
+        if (const std::string_view option = argv[i]; option == "--normals") {
+            add_normals = true;
+        } else {
+            std::cerr << "Invalid option: " << option << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    const auto mesh = load_mesh(argv[1]);
+    if (!mesh) {
+        return 1;
+    }
+
+    bool saved;
+    if (add_normals && mesh->normals.empty()) {
+        // The copy owns every buffer, so nothing ties it to the input file's mapping.
+        const auto copy = [](const auto &span) {
+            return std::vector(span.begin(), span.end());
+        };
+        const bool own_lightmap_uvs = mesh->lightmap_uvs.data() != mesh->uvs.data();
+        const auto with_normals     = MeshData::create(copy(mesh->vertices), copy(mesh->uvs), copy(mesh->indices),
+                                                       vertex_normals(*mesh),
+                                                       own_lightmap_uvs ? copy(mesh->lightmap_uvs)
+                                                                        : std::vector<float>{});
+        saved = save_mesh(*with_normals, argv[2]);
+    } else {
+        saved = save_mesh(*mesh, argv[2]);
+    }
+
+    if (!saved) {
+        std::cerr << "Error writing file: " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << mesh->vertex_count() << " vertices and " << mesh->triangle_count() << " triangles to "
+              << argv[2] << std::endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef MESHDATA_H
+#define MESHDATA_H
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <glm.hpp>
+
+#define BOUNDS_LANES 8
+
+/*
+ * CPU-side geometry for baking: positions (xyz), UVs (st), triangle indices and, optionally, vertex normals and a
+ * separate lightmap UV set. The spans point into storage the mesh keeps alive (usually a mapped mesh file), so the
+ * data is never copied on its way to Embree.
+ * Positions have to stay readable for 4 bytes past their end: Embree loads the last vertex with a 16-byte read.
+ */
+class MeshData final {
+    std::shared_ptr<const void> m_storage;
+    std::span<const float>      m_vertices;
+    std::span<const float>      m_uvs;
+    std::span<const uint32_t>   m_indices;
+    std::span<const float>      m_normals;
+    std::span<const float>      m_lightmap_uvs;
+    glm::vec3                   m_min{FLT_MAX}, m_max{-FLT_MAX};
+
+    /*
+     * Positions are interleaved xyz, so BOUNDS_LANES vertices are 3 * BOUNDS_LANES contiguous floats whose lane
+     * i always holds axis i % 3. Element-wise min/max over such blocks vectorises; the lanes fold into axes last.
+     */
+    void compute_bounds() {
+        constexpr size_t block = 3 * BOUNDS_LANES;
+        float            lo[block], hi[block];
+        std::fill(std::begin(lo), std::end(lo), FLT_MAX);
+        std::fill(std::begin(hi), std::end(hi), -FLT_MAX);
+
+        const float *positions = m_vertices.data();
+        const size_t count     = m_vertices.size() / 3 * 3;
+        size_t       first     = 0;
+        for (; first + block <= count; first += block) {
+            for (size_t lane = 0; lane < block; ++lane) {
+                lo[lane] = std::min(lo[lane], positions[first + lane]);
+                hi[lane] = std::max(hi[lane], positions[first + lane]);
+            }
+        }
+        for (size_t lane = 0; first + lane < count; ++lane) {
+            lo[lane] = std::min(lo[lane], positions[first + lane]);
+            hi[lane] = std::max(hi[lane], positions[first + lane]);
+        }
+
+        for (size_t lane = 0; lane < block; ++lane) {
+            m_min[lane % 3] = std::min(m_min[lane % 3], lo[lane]);
+            m_max[lane % 3] = std::max(m_max[lane % 3], hi[lane]);
+        }
+    }
+
+public:
+    const std::span<const float> &   vertices = m_vertices;
+    const std::span<const float> &   uvs      = m_uvs;
+    const std::span<const uint32_t> &indices  = m_indices;
+    const std::span<const float> &   normals  = m_normals; // empty when the file has none
+
+    // The UV set the lightmap is laid out in: the dedicated lightmap channel if there is one, otherwise uvs.
+    const std::span<const float> &lightmap_uvs = m_lightmap_uvs;
+
+    const glm::vec3 &min = m_min;
+    const glm::vec3 &max = m_max;
+
+    /*
+     * Shares the spans' memory, which storage keeps alive. Pass a null storage to borrow memory the caller owns
+     * for at least as long as the mesh.
+     */
+    MeshData(
+        std::shared_ptr<const void> storage,
+        const std::span<const float>    vertices,
+        const std::span<const float>    uvs,
+        const std::span<const uint32_t> indices,
+        const std::span<const float>    normals      = {},
+        const std::span<const float>    lightmap_uvs = {}) : m_storage(std::move(storage)),
+                                                             m_vertices(vertices),
+                                                             m_uvs(uvs),
+                                                             m_indices(indices),
+                                                             m_normals(normals),
+                                                             m_lightmap_uvs(lightmap_uvs.empty() ? uvs : lightmap_uvs) {
+        compute_bounds();
+    }
+
+    // Takes ownership of the buffers without copying them; empty normals and lightmap_uvs mean absent.
+    static std::unique_ptr<MeshData> create(
+        std::vector<float>    vertices,
+        std::vector<float>    uvs,
+        std::vector<uint32_t> indices,
+        std::vector<float>    normals      = {},
+        std::vector<float>    lightmap_uvs = {});
+
+    MeshData(const MeshData &)            = delete;
+    MeshData &operator=(const MeshData &) = delete;
+
+    [[nodiscard]] uint32_t vertex_count() const {
+        return static_cast<uint32_t>(m_vertices.size() / 3);
+    }
+
+    [[nodiscard]] uint32_t triangle_count() const {
+        return static_cast<uint32_t>(m_indices.size() / 3);
+    }
+};
+
+inline std::unique_ptr<MeshData> MeshData::create(
+    std::vector<float>    vertices,
+    std::vector<float>    uvs,
+    std::vector<uint32_t> indices,
+    std::vector<float>    normals,
+    std::vector<float>    lightmap_uvs) {
+    struct Buffers final {
+        std::vector<float>    vertices, uvs, normals, lightmap_uvs;
+        std::vector<uint32_t> indices;
+    };
+
+    // One zeroed vertex past the end is the padding Embree reads; it only reallocates if capacity is short.
+    const size_t vertex_floats = vertices.size();
+    vertices.resize(vertex_floats + 3, 0.0F);
+
+    const auto buffers = std::make_shared<const Buffers>(Buffers{
+        std::move(vertices), std::move(uvs), std::move(normals), std::move(lightmap_uvs), std::move(indices)
+    });
+    return std::make_unique<MeshData>(buffers,
+                                      std::span(buffers->vertices.data(), vertex_floats),
+                                      std::span<const float>(buffers->uvs),
+                                      std::span<const uint32_t>(buffers->indices),
+                                      std::span<const float>(buffers->normals),
+                                      std::span<const float>(buffers->lightmap_uvs));
+}
+
+#endif //MESHDATA_H
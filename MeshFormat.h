@@ -0,0 +1,54 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef MESHFORMAT_H
+#define MESHFORMAT_H
+#include <cstdint>
+
+/*
+ * Mesh file format v2, little endian:
+ *   MeshFileHeader, then section_count MeshSectionEntry records, then the sections themselves.
+ * Every section starts at a multiple of MESH_SECTION_ALIGNMENT and is followed by at least MESH_SECTION_PADDING
+ * readable bytes, so a mapped file can be handed to Embree and SIMD loads as is. Sections may come in any order;
+ * readers skip types they don't know. Version 1 files (two int32 counts and raw arrays) have no header at all.
+ */
+
+#define MESH_FILE_MAGIC        "TUCANMSH"
+#define MESH_FILE_MAGIC_SIZE   8
+#define MESH_FILE_VERSION      2
+#define MESH_SECTION_ALIGNMENT 64
+#define MESH_SECTION_PADDING   16
+
+enum class MeshSectionType : uint32_t {
+    Positions   = 1, // float x, y, z per vertex
+    Normals     = 2, // float x, y, z per vertex, optional
+    Uvs         = 3, // float s, t per vertex
+    LightmapUvs = 4, // float s, t per vertex, optional; the bake uses Uvs when absent
+    Indices     = 5  // uint32 per triangle corner
+};
+
+enum class MeshCodec : uint32_t {
+    Raw = 0 // stored as is; the only codec readers accept so far
+};
+
+struct MeshFileHeader final {
+    char     magic[MESH_FILE_MAGIC_SIZE];
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t vertex_count;
+    uint64_t index_count;
+};
+
+struct MeshSectionEntry final {
+    MeshSectionType type;
+    MeshCodec       codec;
+    uint64_t        offset; // from the start of the file
+    uint64_t        size;   // stored bytes
+    uint64_t        reserved;
+};
+
+static_assert(sizeof(MeshFileHeader) == 32);
+static_assert(sizeof(MeshSectionEntry) == 32);
+
+#endif //MESHFORMAT_H
@@ -0,0 +1,207 @@
+//
+// Created on 17.10.2026.
+//
+
+#include "MeshLoader.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "MappedFile.h"
+#include "MeshFormat.h"
+
+template<typename T>
+static T read_data(const uint8_t *buffer, size_t &ptr) {
+    T                data;
+    constexpr size_t size = sizeof(T);
+    std::memcpy(&data, &buffer[ptr], size);
+    ptr += size;
+    return data;
+}
+
+template<typename T>
+static std::span<const T> section_span(const MappedFile &file, const size_t offset, const size_t count) {
+    return {reinterpret_cast<const T *>(file.data() + offset), count};
+}
+
+static size_t align_up(const size_t value, const size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static std::unique_ptr<MeshData> load_mesh_v1(std::shared_ptr<const MappedFile> file, const std::string &file_name) {
+    size_t     ptr  = 0;
+    const auto size = file->size();
+    if (size < 2 * sizeof(int32_t)) {
+        std::cerr << "Truncated mesh file: " << file_name << std::endl;
+        return nullptr;
+    }
+    const auto vertex_count = read_data<int32_t>(file->data(), ptr);
+    const auto index_count  = read_data<int32_t>(file->data(), ptr);
+
+    const size_t vertices_offset = ptr;
+    const size_t uvs_offset      = vertices_offset + static_cast<size_t>(vertex_count) * 3 * sizeof(float);
+    const size_t indices_offset  = uvs_offset + static_cast<size_t>(vertex_count) * 2 * sizeof(float);
+    const size_t end             = indices_offset + static_cast<size_t>(index_count) * sizeof(uint32_t);
+    if (vertex_count < 0 || index_count < 0 || end > size) {
+        std::cerr << "Truncated mesh file: " << file_name << std::endl;
+        return nullptr;
+    }
+
+    // The header is 8 bytes and every section holds 4-byte elements, so all three spans are 4-byte aligned within
+    // the page-aligned mapping. The UVs right after the positions give Embree its padding past the last vertex.
+    const auto vertices = section_span<float>(*file, vertices_offset, static_cast<size_t>(vertex_count) * 3);
+    const auto uvs      = section_span<float>(*file, uvs_offset, static_cast<size_t>(vertex_count) * 2);
+    const auto indices  = section_span<uint32_t>(*file, indices_offset, static_cast<size_t>(index_count));
+    return std::make_unique<MeshData>(std::move(file), vertices, uvs, indices);
+}
+
+/*
+ * Only the header and section table are read here; the mapping pulls in each section's pages as the bake first
+ * touches them, so positions are being consumed while the kernel is still reading the rest of the file.
+ */
+static std::unique_ptr<MeshData> load_mesh_v2(std::shared_ptr<const MappedFile> file, const std::string &file_name) {
+    size_t     ptr  = 0;
+    const auto size = file->size();
+    if (size < sizeof(MeshFileHeader)) {
+        std::cerr << "Truncated mesh file: " << file_name << std::endl;
+        return nullptr;
+    }
+    const auto header = read_data<MeshFileHeader>(file->data(), ptr);
+    if (header.version != MESH_FILE_VERSION) {
+        std::cerr << "Unsupported mesh file version " << header.version << ": " << file_name << std::endl;
+        return nullptr;
+    }
+    // Counts larger than the file can hold would overflow the section size checks below.
+    if (header.section_count > (size - ptr) / sizeof(MeshSectionEntry) ||
+        header.vertex_count > size / sizeof(float) || header.index_count > size / sizeof(uint32_t)) {
+        std::cerr << "Truncated mesh file: " << file_name << std::endl;
+        return nullptr;
+    }
+
+    std::span<const float>    vertices, uvs, normals, lightmap_uvs;
+    std::span<const uint32_t> indices;
+    for (uint32_t si = 0; si < header.section_count; ++si) {
+        const auto section = read_data<MeshSectionEntry>(file->data(), ptr);
+        if (section.offset % MESH_SECTION_ALIGNMENT != 0 || section.offset > size ||
+            size - section.offset < MESH_SECTION_PADDING ||
+            section.size > size - section.offset - MESH_SECTION_PADDING) {
+            std::cerr << "Corrupt mesh section table: " << file_name << std::endl;
+            return nullptr;
+        }
+        if (section.codec != MeshCodec::Raw) {
+            std::cerr << "Unsupported mesh section codec " << static_cast<uint32_t>(section.codec) << ": "
+                      << file_name << std::endl;
+            return nullptr;
+        }
+
+        const auto floats_per_vertex = [&header, &section](const uint64_t components) {
+            return section.size == header.vertex_count * components * sizeof(float);
+        };
+        bool valid = true;
+        switch (section.type) {
+            case MeshSectionType::Positions:
+                valid    = floats_per_vertex(3);
+                vertices = section_span<float>(*file, section.offset, header.vertex_count * 3);
+                break;
+            case MeshSectionType::Normals:
+                valid   = floats_per_vertex(3);
+                normals = section_span<float>(*file, section.offset, header.vertex_count * 3);
+                break;
+            case MeshSectionType::Uvs:
+                valid = floats_per_vertex(2);
+                uvs   = section_span<float>(*file, section.offset, header.vertex_count * 2);
+                break;
+            case MeshSectionType::LightmapUvs:
+                valid        = floats_per_vertex(2);
+                lightmap_uvs = section_span<float>(*file, section.offset, header.vertex_count * 2);
+                break;
+            case MeshSectionType::Indices:
+                valid   = section.size == header.index_count * sizeof(uint32_t);
+                indices = section_span<uint32_t>(*file, section.offset, header.index_count);
+                break;
+            default:
+                break;
+        }
+        if (!valid) {
+            std::cerr << "Mesh section " << static_cast<uint32_t>(section.type) << " doesn't match the header counts: "
+                      << file_name << std::endl;
+            return nullptr;
+        }
+    }
+
+    if (vertices.size() != header.vertex_count * 3 || uvs.size() != header.vertex_count * 2 ||
+        indices.size() != header.index_count) {
+        std::cerr << "Mesh file lacks positions, UVs or indices: " << file_name << std::endl;
+        return nullptr;
+    }
+    return std::make_unique<MeshData>(std::move(file), vertices, uvs, indices, normals, lightmap_uvs);
+}
+
+std::unique_ptr<MeshData> load_mesh(const std::string &file_name) {
+    auto file = std::make_shared<const MappedFile>(file_name);
+    if (!file->is_open()) {
+        std::cerr << "Error opening file: " << file_name << std::endl;
+        return nullptr;
+    }
+
+    if (file->size() >= MESH_FILE_MAGIC_SIZE &&
+        std::memcmp(file->data(), MESH_FILE_MAGIC, MESH_FILE_MAGIC_SIZE) == 0) {
+        return load_mesh_v2(std::move(file), file_name);
+    }
+    return load_mesh_v1(std::move(file), file_name);
+}
+
+bool save_mesh(const MeshData &mesh, const std::string &file_name) {
+    struct Section final {
+        MeshSectionType type;
+        const void *    data;
+        size_t          size;
+    };
+    std::vector<Section> sections = {
+        {MeshSectionType::Positions, mesh.vertices.data(), mesh.vertices.size_bytes()},
+        {MeshSectionType::Uvs, mesh.uvs.data(), mesh.uvs.size_bytes()},
+        {MeshSectionType::Indices, mesh.indices.data(), mesh.indices.size_bytes()},
+    };
+    if (!mesh.normals.empty()) {
+        sections.push_back({MeshSectionType::Normals, mesh.normals.data(), mesh.normals.size_bytes()});
+    }
+    if (mesh.lightmap_uvs.data() != mesh.uvs.data()) {
+        sections.push_back({MeshSectionType::LightmapUvs, mesh.lightmap_uvs.data(), mesh.lightmap_uvs.size_bytes()});
+    }
+
+    MeshFileHeader header{};
+    std::memcpy(header.magic, MESH_FILE_MAGIC, MESH_FILE_MAGIC_SIZE);
+    header.version       = MESH_FILE_VERSION;
+    header.section_count = static_cast<uint32_t>(sections.size());
+    header.vertex_count  = mesh.vertex_count();
+    header.index_count   = mesh.indices.size();
+
+    std::vector<MeshSectionEntry> entries;
+    size_t offset = align_up(sizeof(MeshFileHeader) + sections.size() * sizeof(MeshSectionEntry),
+                             MESH_SECTION_ALIGNMENT);
+    for (const auto &[type, data, size]: sections) {
+        entries.push_back({type, MeshCodec::Raw, offset, size, 0});
+        offset = align_up(offset + size + MESH_SECTION_PADDING, MESH_SECTION_ALIGNMENT);
+    }
+
+    std::ofstream output_stream(file_name, std::ios::binary);
+    if (!output_stream) {
+        return false;
+    }
+    output_stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output_stream.write(reinterpret_cast<const char *>(entries.data()),
+                        static_cast<std::streamsize>(entries.size() * sizeof(MeshSectionEntry)));
+
+    const std::vector<char> zeros(MESH_SECTION_ALIGNMENT + MESH_SECTION_PADDING, 0);
+    for (size_t si = 0; si < sections.size(); ++si) {
+        const auto position = static_cast<size_t>(output_stream.tellp());
+        output_stream.write(zeros.data(), static_cast<std::streamsize>(entries[si].offset - position));
+        output_stream.write(static_cast<const char *>(sections[si].data),
+                            static_cast<std::streamsize>(sections[si].size));
+    }
+    output_stream.write(zeros.data(), static_cast<std::streamsize>(
+                            offset - static_cast<size_t>(output_stream.tellp())));
+    return static_cast<bool>(output_stream);
+}
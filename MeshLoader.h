@@ -0,0 +1,23 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef MESHLOADER_H
+#define MESHLOADER_H
+#include <memory>
+#include <string>
+
+#include "MeshData.h"
+
+/*
+ * Reads a mesh file of either format (see MeshFormat.h). Version 1 is an int32 vertex count, an int32 index count,
+ * then vertex positions (3 floats each), UVs (2 floats each) and uint32 indices. The file is memory mapped and the
+ * mesh points into the mapping, so loading costs no copies and large files are addressed with 64-bit offsets.
+ * Returns nullptr if the file can't be opened or is malformed.
+ */
+std::unique_ptr<MeshData> load_mesh(const std::string &file_name);
+
+// Writes the mesh in format version 2, including its normals and lightmap UVs if it has them.
+bool save_mesh(const MeshData &mesh, const std::string &file_name);
+
+#endif //MESHLOADER_H
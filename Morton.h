@@ -0,0 +1,29 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef MORTON_H
+#define MORTON_H
+#include <cstdint>
+
+#include <glm.hpp>
+
+#define MORTON_AXIS_BITS 10
+
+// Spreads the low MORTON_AXIS_BITS bits of value two bits apart.
+inline uint32_t morton_spread_bits(uint32_t value) {
+    value = (value | value << 16) & 0x030000FF;
+    value = (value | value << 8) & 0x0300F00F;
+    value = (value | value << 4) & 0x030C30C3;
+    value = (value | value << 2) & 0x09249249;
+    return value;
+}
+
+// 30-bit Morton code of pt's cell in a 2^MORTON_AXIS_BITS grid over the box; points outside are clamped onto it.
+inline uint32_t morton_code(const glm::vec3 &pt, const glm::vec3 &bounds_min, const glm::vec3 &bounds_extent) {
+    constexpr float  cells = (1U << MORTON_AXIS_BITS) - 1;
+    const glm::uvec3 cell  = glm::clamp((pt - bounds_min) / bounds_extent, 0.0F, 1.0F) * cells;
+    return morton_spread_bits(cell.x) << 2 | morton_spread_bits(cell.y) << 1 | morton_spread_bits(cell.z);
+}
+
+#endif //MORTON_H
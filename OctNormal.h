@@ -0,0 +1,33 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef OCTNORMAL_H
+#define OCTNORMAL_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <glm.hpp>
+#include <gtc/packing.hpp>
+
+// Unit normal folded onto an octahedron and stored as two snorm16 values.
+inline uint32_t pack_normal(const glm::vec3 &normal) {
+    glm::vec2 oct = glm::vec2(normal) / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+    if (normal.z < 0.0F) {
+        oct = (1.0F - glm::abs(glm::vec2(oct.y, oct.x))) *
+              glm::vec2(oct.x >= 0.0F ? 1.0F : -1.0F, oct.y >= 0.0F ? 1.0F : -1.0F);
+    }
+    return glm::packSnorm2x16(oct);
+}
+
+inline glm::vec3 unpack_normal(const uint32_t packed) {
+    const glm::vec2 oct    = glm::unpackSnorm2x16(packed);
+    glm::vec3       normal = {oct.x, oct.y, 1.0F - std::abs(oct.x) - std::abs(oct.y)};
+    const float     fold   = std::max(-normal.z, 0.0F);
+    normal.x += normal.x >= 0.0F ? -fold : fold;
+    normal.y += normal.y >= 0.0F ? -fold : fold;
+    return normalize(normal);
+}
+
+#endif //OCTNORMAL_H
@@ -0,0 +1,126 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef PATCHSTORE_H
+#define PATCHSTORE_H
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "Morton.h"
+#include "OctNormal.h"
+#include <glm.hpp>
+
+// One texel sample on a triangle, as the rasterizer produces it.
+struct Patch final {
+    glm::ivec2 pixel_coords;
+    uint32_t   normal; // packed with pack_normal()
+    glm::vec3  world_coords;
+    uint32_t   triangle;
+    uint32_t   flags;
+};
+
+/*
+ * Structure-of-arrays patch storage for the bake loop: positions per axis, octahedral snorm16 normals and
+ * row-major texel indices. Built from rasterizer output, optionally reordered along a 3D Morton curve so that
+ * consecutive patches, and the rays they trace, stay close together in the BVH.
+ */
+class PatchStore final {
+    std::vector<float>    m_x, m_y, m_z;
+    std::vector<uint32_t> m_normals;
+    std::vector<uint32_t> m_texels;
+    std::vector<uint32_t> m_triangles;
+    std::vector<uint32_t> m_flags;
+    uint32_t              m_width = 0;
+
+public:
+    /*
+     * Returns, for every input patch, its index in the store. With bounds_min < bounds_max the store is sorted
+     * by the Morton code of world_coords within those bounds, otherwise input order is kept.
+     */
+    std::vector<uint32_t> build(
+        const std::vector<Patch> &patches,
+        const uint32_t            width,
+        const glm::vec3 &         bounds_min = glm::vec3(0.0F),
+        const glm::vec3 &         bounds_max = glm::vec3(0.0F)) {
+        const auto count = static_cast<uint32_t>(patches.size());
+        m_width          = width;
+
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        if (const glm::vec3 extent = bounds_max - bounds_min; extent.x > 0.0F && extent.y > 0.0F && extent.z > 0.0F) {
+            std::vector<uint32_t> codes(count);
+            for (uint32_t pi = 0; pi < count; ++pi) {
+                codes[pi] = morton_code(patches[pi].world_coords, bounds_min, extent);
+            }
+            std::ranges::stable_sort(order, [&codes](const uint32_t a, const uint32_t b) {
+                return codes[a] < codes[b];
+            });
+        }
+
+        m_x.resize(count);
+        m_y.resize(count);
+        m_z.resize(count);
+        m_normals.resize(count);
+        m_texels.resize(count);
+        m_triangles.resize(count);
+        m_flags.resize(count);
+
+        std::vector<uint32_t> remap(count);
+        for (uint32_t si = 0; si < count; ++si) {
+            const Patch &patch = patches[order[si]];
+            m_x[si]            = patch.world_coords.x;
+            m_y[si]            = patch.world_coords.y;
+            m_z[si]            = patch.world_coords.z;
+            m_normals[si]      = patch.normal;
+            m_texels[si]       = static_cast<uint32_t>(patch.pixel_coords.y) * width +
+                                 static_cast<uint32_t>(patch.pixel_coords.x);
+            m_triangles[si]    = patch.triangle;
+            m_flags[si]        = patch.flags;
+            remap[order[si]]   = si;
+        }
+        return remap;
+    }
+
+    [[nodiscard]] uint32_t size() const {
+        return static_cast<uint32_t>(m_texels.size());
+    }
+
+    [[nodiscard]] glm::vec3 position(const uint32_t patch) const {
+        return {m_x[patch], m_y[patch], m_z[patch]};
+    }
+
+    [[nodiscard]] glm::vec3 normal(const uint32_t patch) const {
+        return unpack_normal(m_normals[patch]);
+    }
+
+    [[nodiscard]] uint32_t texel(const uint32_t patch) const {
+        return m_texels[patch];
+    }
+
+    [[nodiscard]] glm::ivec2 pixel_coords(const uint32_t patch) const {
+        return {static_cast<int32_t>(m_texels[patch] % m_width), static_cast<int32_t>(m_texels[patch] / m_width)};
+    }
+
+    [[nodiscard]] uint32_t triangle(const uint32_t patch) const {
+        return m_triangles[patch];
+    }
+
+    [[nodiscard]] uint32_t flags(const uint32_t patch) const {
+        return m_flags[patch];
+    }
+
+    [[nodiscard]] uint32_t &flags(const uint32_t patch) {
+        return m_flags[patch];
+    }
+
+    [[nodiscard]] uint32_t count_flags(const uint32_t mask) const {
+        return static_cast<uint32_t>(std::ranges::count_if(m_flags, [mask](const uint32_t flags) {
+            return (flags & mask) != 0;
+        }));
+    }
+};
+
+#endif //PATCHSTORE_H
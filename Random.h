@@ -0,0 +1,57 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef RANDOM_H
+#define RANDOM_H
+#include <array>
+#include <cstdint>
+
+#define PHILOX_ROUNDS 10
+
+using Philox4 = std::array<uint32_t, 4>;
+
+/*
+ * Philox4x32-10 (Salmon et al. 2011). A pure function of counter and key: no state is shared between threads,
+ * so every texel/sample pair draws the same numbers however the bake is scheduled.
+ */
+inline Philox4 philox4x32(Philox4 counter, uint32_t key_lo, uint32_t key_hi) {
+    constexpr uint32_t mul_a  = 0xD2511F53U;
+    constexpr uint32_t mul_b  = 0xCD9E8D57U;
+    constexpr uint32_t weyl_a = 0x9E3779B9U;
+    constexpr uint32_t weyl_b = 0xBB67AE85U;
+    for (int32_t round = 0; round < PHILOX_ROUNDS; ++round) {
+        const uint64_t product_a = static_cast<uint64_t>(mul_a) * counter[0];
+        const uint64_t product_b = static_cast<uint64_t>(mul_b) * counter[2];
+        counter = {
+            static_cast<uint32_t>(product_b >> 32) ^ counter[1] ^ key_lo,
+            static_cast<uint32_t>(product_b),
+            static_cast<uint32_t>(product_a >> 32) ^ counter[3] ^ key_hi,
+            static_cast<uint32_t>(product_a)
+        };
+        key_lo += weyl_a;
+        key_hi += weyl_b;
+    }
+    return counter;
+}
+
+/*
+ * Fills count values for consecutive sample indices starting at first. Lanes are independent, so the loop
+ * vectorizes across samples.
+ */
+inline void philox_uniform2(
+    const uint32_t seed,
+    const uint32_t stream,
+    const uint32_t dimension,
+    const uint32_t first,
+    const uint32_t count,
+    float *        u,
+    float *        v) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const Philox4 bits = philox4x32({first + i, stream, dimension, 0}, seed, 0x85EBCA6BU);
+        u[i]               = static_cast<float>(bits[0] >> 8) * 0x1p-24F;
+        v[i]               = static_cast<float>(bits[1] >> 8) * 0x1p-24F;
+    }
+}
+
+#endif //RANDOM_H
@@ -0,0 +1,97 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef RAYQUEUE_H
+#define RAYQUEUE_H
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "Morton.h"
+#include "Visibility.h"
+#include <glm.hpp>
+
+#define RAY_QUEUE_INDEX_BITS 16
+#define RAY_QUEUE_SIZE       (1U << RAY_QUEUE_INDEX_BITS)
+
+/*
+ * Batches occlusion rays from many texels and traces them sorted by direction octant, then by the Morton cell
+ * of their origin, so each packet handed to Embree holds rays that head the same way from nearby points.
+ * Every ray carries the slot of the texel it belongs to; flush() reports occluded rays per slot.
+ */
+class RayQueue final {
+    std::vector<glm::vec3> m_origins, m_dirs;
+    std::vector<uint32_t>  m_slots;
+    std::vector<uint64_t>  m_order;
+
+public:
+    RayQueue() {
+        m_origins.reserve(RAY_QUEUE_SIZE);
+        m_dirs.reserve(RAY_QUEUE_SIZE);
+        m_slots.reserve(RAY_QUEUE_SIZE);
+        m_order.reserve(RAY_QUEUE_SIZE);
+    }
+
+    [[nodiscard]] uint32_t size() const {
+        return static_cast<uint32_t>(m_slots.size());
+    }
+
+    [[nodiscard]] bool fits(const uint32_t count) const {
+        return size() + count <= RAY_QUEUE_SIZE;
+    }
+
+    // The caller makes room with fits() and flush(); the sort key has only RAY_QUEUE_INDEX_BITS for the ray index.
+    void push(const glm::vec3 &origin, const glm::vec3 &dir, const uint32_t slot) {
+        assert(size() < RAY_QUEUE_SIZE);
+        m_origins.push_back(origin);
+        m_dirs.push_back(dir);
+        m_slots.push_back(slot);
+    }
+
+    // Traces everything queued over [tmin, tmax] and calls on_occluded(slot) once per blocked ray.
+    template<typename Fn>
+    void flush(
+        const RTCScene        scene,
+        RTCOccludedArguments *args,
+        const glm::vec3 &     bounds_min,
+        const glm::vec3 &     bounds_extent,
+        const float           tmin,
+        const float           tmax,
+        const Fn &            on_occluded) {
+        m_order.resize(m_slots.size());
+        for (uint32_t ri = 0; ri < m_slots.size(); ++ri) {
+            const glm::vec3 &dir    = m_dirs[ri];
+            const uint64_t   octant = (dir.x < 0.0F ? 4U : 0U) | (dir.y < 0.0F ? 2U : 0U) | (dir.z < 0.0F ? 1U : 0U);
+            const uint64_t   cell   = morton_code(m_origins[ri], bounds_min, bounds_extent);
+            m_order[ri]             = (octant << 3 * MORTON_AXIS_BITS | cell) << RAY_QUEUE_INDEX_BITS | ri;
+        }
+        std::ranges::sort(m_order);
+
+        OcclusionPacket<> packet;
+        uint32_t          lane_rays[RAY_PACKET_SIZE];
+        for (size_t first = 0; first < m_order.size(); first += RAY_PACKET_SIZE) {
+            const auto count = static_cast<uint32_t>(std::min<size_t>(m_order.size() - first, RAY_PACKET_SIZE));
+            for (uint32_t lane = 0; lane < count; ++lane) {
+                const auto ri   = static_cast<uint32_t>(m_order[first + lane] & (RAY_QUEUE_SIZE - 1));
+                lane_rays[lane] = ri;
+                packet.push(m_origins[ri], m_dirs[ri], tmin, tmax);
+            }
+            packet.trace(scene, args);
+            for (uint32_t lane = 0; lane < count; ++lane) {
+                if (packet.occluded(lane)) {
+                    on_occluded(m_slots[lane_rays[lane]]);
+                }
+            }
+            packet.clear();
+        }
+
+        m_origins.clear();
+        m_dirs.clear();
+        m_slots.clear();
+        m_order.clear();
+    }
+};
+
+#endif //RAYQUEUE_H
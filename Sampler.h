@@ -0,0 +1,264 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Random.h"
+
+#define SAMPLE_TO_FLOAT(VALUE) (static_cast<float>((VALUE) >> 8) * 0x1p-24F)
+#define BLUE_NOISE_TILE_SIZE   64
+
+enum class SamplerType : uint8_t {
+    Random,
+    Sobol,
+    Halton,
+    BlueNoise
+};
+
+/*
+ * Source of 2D sample points. A stream is identified by a texel and a dimension (0 for AO),
+ * and consecutive sample indices of a stream are well stratified. Streams of different texels are decorrelated.
+ */
+class Sampler {
+protected:
+    uint32_t m_seed;
+    uint32_t m_width;
+
+    [[nodiscard]] static uint32_t hash(uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x7FEB352DU;
+        x ^= x >> 15;
+        x *= 0x846CA68BU;
+        x ^= x >> 16;
+        return x;
+    }
+
+    [[nodiscard]] static uint32_t reverse_bits(uint32_t x) {
+        x = (x << 16) | (x >> 16);
+        x = ((x & 0x00FF00FFU) << 8) | ((x & 0xFF00FF00U) >> 8);
+        x = ((x & 0x0F0F0F0FU) << 4) | ((x & 0xF0F0F0F0U) >> 4);
+        x = ((x & 0x33333333U) << 2) | ((x & 0xCCCCCCCCU) >> 2);
+        x = ((x & 0x55555555U) << 1) | ((x & 0xAAAAAAAAU) >> 1);
+        return x;
+    }
+
+    [[nodiscard]] static uint32_t hash_combine(const uint32_t seed, const uint32_t value) {
+        return seed ^ (value + 0x9E3779B9U + (seed << 6) + (seed >> 2));
+    }
+
+    [[nodiscard]] uint32_t stream_seed(const uint32_t texel, const uint32_t dimension) const {
+        return hash(hash_combine(hash_combine(m_seed, texel), dimension));
+    }
+
+public:
+    Sampler(const uint32_t seed, const uint32_t width) : m_seed(seed), m_width(width) {
+    }
+
+    virtual ~Sampler() = default;
+
+    virtual void generate(
+        uint32_t texel,
+        uint32_t dimension,
+        uint32_t first,
+        uint32_t count,
+        float *  u,
+        float *  v) const = 0;
+
+    static std::unique_ptr<Sampler> create(SamplerType type, uint32_t seed, uint32_t width);
+};
+
+// Independent uniform samples from the counter-based generator.
+class RandomSampler final : public Sampler {
+public:
+    using Sampler::Sampler;
+
+    void generate(
+        const uint32_t texel,
+        const uint32_t dimension,
+        const uint32_t first,
+        const uint32_t count,
+        float *        u,
+        float *        v) const override {
+        philox_uniform2(m_seed, texel, dimension, first, count, u, v);
+    }
+};
+
+// Sobol (0, 2)-sequence with hash-based Owen scrambling (Burley 2020).
+class SobolSampler final : public Sampler {
+    [[nodiscard]] static uint32_t laine_karras_permutation(uint32_t x, const uint32_t seed) {
+        x += seed;
+        x ^= x * 0x6C50B47CU;
+        x ^= x * 0xB82F1E52U;
+        x ^= x * 0xC7AFE638U;
+        x ^= x * 0x8D22F6E6U;
+        return x;
+    }
+
+    [[nodiscard]] static uint32_t nested_uniform_scramble(const uint32_t x, const uint32_t seed) {
+        return reverse_bits(laine_karras_permutation(reverse_bits(x), seed));
+    }
+
+    [[nodiscard]] static uint32_t sobol_second_dimension(uint32_t index) {
+        uint32_t result    = 0;
+        uint32_t direction = 1U << 31;
+        for (; index != 0; index >>= 1, direction ^= direction >> 1) {
+            if (index & 1U) {
+                result ^= direction;
+            }
+        }
+        return result;
+    }
+
+public:
+    using Sampler::Sampler;
+
+    void generate(
+        const uint32_t texel,
+        const uint32_t dimension,
+        const uint32_t first,
+        const uint32_t count,
+        float *        u,
+        float *        v) const override {
+        const uint32_t seed   = stream_seed(texel, dimension);
+        const uint32_t seed_u = hash(hash_combine(seed, 0));
+        const uint32_t seed_v = hash(hash_combine(seed, 1));
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t index = nested_uniform_scramble(first + i, seed);
+            u[i]                 = SAMPLE_TO_FLOAT(nested_uniform_scramble(reverse_bits(index), seed_u));
+            v[i]                 = SAMPLE_TO_FLOAT(nested_uniform_scramble(sobol_second_dimension(index), seed_v));
+        }
+    }
+};
+
+// Halton bases 2 and 3 with a per-stream Cranley-Patterson rotation.
+class HaltonSampler final : public Sampler {
+    [[nodiscard]] static float radical_inverse_3(uint32_t index) {
+        float result = 0.0F;
+        float digit  = 1.0F / 3.0F;
+        for (; index != 0; index /= 3, digit /= 3.0F) {
+            result += static_cast<float>(index % 3) * digit;
+        }
+        return result;
+    }
+
+public:
+    using Sampler::Sampler;
+
+    void generate(
+        const uint32_t texel,
+        const uint32_t dimension,
+        const uint32_t first,
+        const uint32_t count,
+        float *        u,
+        float *        v) const override {
+        const uint32_t seed     = stream_seed(texel, dimension);
+        const float    offset_u = SAMPLE_TO_FLOAT(hash(seed));
+        const float    offset_v = SAMPLE_TO_FLOAT(hash(seed ^ 0x5BD1E995U));
+        for (uint32_t i = 0; i < count; ++i) {
+            const float base_u = SAMPLE_TO_FLOAT(reverse_bits(first + i));
+            const float base_v = radical_inverse_3(first + i);
+            u[i]               = base_u + offset_u - static_cast<float>(base_u + offset_u >= 1.0F);
+            v[i]               = base_v + offset_v - static_cast<float>(base_v + offset_v >= 1.0F);
+        }
+    }
+};
+
+/*
+ * Per-texel offsets from a tiled blue-noise mask, advanced along the R2 sequence. Neighbouring texels get
+ * dissimilar offsets, so the residual error is high-frequency and is largely removed by dilation and filtering.
+ */
+class BlueNoiseSampler final : public Sampler {
+    static const std::vector<float> &tile() {
+        static const std::vector<float> mask = build_tile();
+        return mask;
+    }
+
+    // Void-and-cluster style ranking: each step fills the pixel that sits in the largest void so far.
+    static std::vector<float> build_tile() {
+        constexpr int32_t size  = BLUE_NOISE_TILE_SIZE;
+        constexpr int32_t count = size * size;
+        constexpr float   sigma = 1.5F;
+
+        std::vector<float> kernel(count);
+        for (int32_t y = 0; y < size; ++y) {
+            for (int32_t x = 0; x < size; ++x) {
+                const auto dx        = static_cast<float>(std::min(x, size - x));
+                const auto dy        = static_cast<float>(std::min(y, size - y));
+                kernel[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2.0F * sigma * sigma));
+            }
+        }
+
+        std::vector<float> energy(count, 0.0F);
+        std::vector<float> mask(count, -1.0F);
+        for (int32_t rank = 0; rank < count; ++rank) {
+            int32_t best = -1;
+            for (int32_t p = 0; p < count; ++p) {
+                if (mask[p] < 0.0F && (best < 0 || energy[p] < energy[best])) {
+                    best = p;
+                }
+            }
+            mask[best]       = (static_cast<float>(rank) + 0.5F) / static_cast<float>(count);
+            const int32_t bx = best % size;
+            const int32_t by = best / size;
+            for (int32_t y = 0; y < size; ++y) {
+                const int32_t ky = (y - by + size) % size;
+                for (int32_t x = 0; x < size; ++x) {
+                    energy[y * size + x] += kernel[ky * size + (x - bx + size) % size];
+                }
+            }
+        }
+        return mask;
+    }
+
+public:
+    BlueNoiseSampler(const uint32_t seed, const uint32_t width) : Sampler(seed, width) {
+        static_cast<void>(tile());
+    }
+
+    void generate(
+        const uint32_t texel,
+        const uint32_t dimension,
+        const uint32_t first,
+        const uint32_t count,
+        float *        u,
+        float *        v) const override {
+        constexpr uint32_t size   = BLUE_NOISE_TILE_SIZE;
+        constexpr uint32_t r2_u   = 3242174890U; // R2 sequence steps in 0.32 fixed point
+        constexpr uint32_t r2_v   = 2447445414U;
+        const auto &       mask   = tile();
+        const uint32_t     shift  = m_seed + dimension * 23;
+        const uint32_t     x      = texel % std::max(m_width, 1U) + shift;
+        const uint32_t     y      = texel / std::max(m_width, 1U) + shift * 3;
+        const float        base_u = mask[(y % size) * size + x % size];
+        const float        base_v = mask[((y + size / 2) % size) * size + (x + size / 2 + 7) % size];
+        for (uint32_t i = 0; i < count; ++i) {
+            const float su = base_u + SAMPLE_TO_FLOAT((first + i) * r2_u);
+            const float sv = base_v + SAMPLE_TO_FLOAT((first + i) * r2_v);
+            u[i]           = su - static_cast<float>(su >= 1.0F);
+            v[i]           = sv - static_cast<float>(sv >= 1.0F);
+        }
+    }
+};
+
+inline std::unique_ptr<Sampler> Sampler::create(const SamplerType type, const uint32_t seed, const uint32_t width) {
+    switch (type) {
+        case SamplerType::Random:
+            return std::make_unique<RandomSampler>(seed, width);
+        case SamplerType::Halton:
+            return std::make_unique<HaltonSampler>(seed, width);
+        case SamplerType::BlueNoise:
+            return std::make_unique<BlueNoiseSampler>(seed, width);
+        case SamplerType::Sobol:
+        default:
+            return std::make_unique<SobolSampler>(seed, width);
+    }
+}
+
+#endif //SAMPLER_H
@@ -4,6 +4,10 @@
 
 #include "Scene.h"
 
+#include <array>
+#include <chrono>
+#include <string>
+
 glm::vec3 Scene::get_perp_vec(const glm::vec3 &u) {
     const glm::vec3 a  = glm::abs(u);
     const uint32_t  xm = a.x - a.y < 0 && a.x - a.z < 0 ? 1 : 0;
@@ -12,34 +16,30 @@ glm::vec3 Scene::get_perp_vec(const glm::vec3 &u) {
     return cross(u, glm::vec3(xm, ym, zm));
 }
 
-glm::vec3 Scene::get_cos_hemisphere_sample(const glm::vec3 &normal) {
-    const auto      rand  = glm::vec2{random_floats(random_engine), random_floats(random_engine)};
-    const glm::vec3 bitan = get_perp_vec(normal);
+void Scene::get_cos_hemisphere_samples(const glm::vec3 &normal, const float *u, const float *v, const uint32_t count,
+                                       glm::vec3 *     dirs) {
+    const glm::vec3 bitan = normalize(get_perp_vec(normal));
     const glm::vec3 tan   = cross(bitan, normal);
-    const float     r     = std::sqrt(rand.x);
-    const float     phi   = 2.0F * 3.14159265F * rand.y;
-    return tan * (r * glm::cos(phi)) + bitan * (r * glm::sin(phi)) + normal * glm::sqrt(1 - rand.x);
+    for (uint32_t i = 0; i < count; ++i) {
+        const float r   = std::sqrt(u[i]);
+        const float phi = 2.0F * 3.14159265F * v[i];
+        dirs[i]         = tan * (r * std::cos(phi)) + bitan * (r * std::sin(phi)) + normal * std::sqrt(1.0F - u[i]);
+    }
 }
 
-RTCRayHit Scene::embree_raycast(const glm::vec3 &ray_origin, const glm::vec3 &ray_dir, const float &tmin,
-                                const float &    tmax) const {
-    RTCRayHit ray_hit{};
-    ray_hit.ray.org_x = ray_origin.x;
-    ray_hit.ray.org_y = ray_origin.y;
-    ray_hit.ray.org_z = ray_origin.z;
-
-    ray_hit.ray.dir_x = ray_dir.x;
-    ray_hit.ray.dir_y = ray_dir.y;
-    ray_hit.ray.dir_z = ray_dir.z;
-
-    ray_hit.ray.mask  = 0xFFFFFFFF;
-    ray_hit.ray.tnear = tmin;
-    ray_hit.ray.tfar  = tmax;
-
-    ray_hit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+uint32_t Scene::embree_occluded(OcclusionPacket<> &packet, RTCOccludedArguments *args) const {
+    if (packet.count() == 0) {
+        return 0;
+    }
+    const uint32_t occluded_num = packet.trace(m_embree_scene, args);
+    packet.clear();
+    return occluded_num;
+}
 
-    rtcIntersect1(m_embree_scene, &ray_hit);
-    return ray_hit;
+glm::vec3 Scene::get_triangle_vertex(const uint32_t triangle, const uint32_t corner) const {
+    const auto &vertices = m_mesh->vertices;
+    const auto  v_ptr    = m_mesh->indices[triangle * 3 + corner] * 3;
+    return {vertices[v_ptr], vertices[v_ptr + 1], vertices[v_ptr + 2]};
 }
 
 glm::vec3 Scene::project_on_plane(const glm::vec3 &normal, const glm::vec3 &pt) {
@@ -55,91 +55,233 @@ glm::vec4 Scene::lerp_rgba(const glm::vec4 &a, const glm::vec4 &b, const float t
     };
 }
 
-Scene::Scene(const glm::vec3 &                   light_dir,
-             Mesh *                              mesh,
-             int32_t                             rays_per_texel,
-             uint32_t                            width,
-             uint32_t                            height,
-             std::initializer_list<TexParameter> parameters) : m_lightmap_texture(width, height, parameters),
-                                                               m_albedo_texture(width, height, parameters, COLOR_WHITE),
-                                                               m_rays_per_texel(rays_per_texel),
-                                                               m_light_main_dir(light_dir) {
+Scene::Scene(const glm::vec3 & light_dir,
+             const MeshData *  mesh,
+             int32_t           rays_per_texel,
+             const BakeConfig &config,
+             uint32_t          width,
+             uint32_t          height) : m_config(config),
+                                         m_thread_pool(config.thread_count),
+                                         m_workers(m_thread_pool.size()),
+                                         m_sampler(Sampler::create(config.sampler, config.seed, width)),
+                                         m_lightmap(width, height),
+                                         m_accumulation(width, height, config.half_accumulation),
+                                         m_rays_per_texel(rays_per_texel),
+                                         m_light_main_dir(light_dir) {
     m_mesh = mesh;
-    std::random_device random_device;
-    random_engine = std::mt19937(random_device());
-    random_floats = std::uniform_real_distribution(0.0F, 1.0F);
-
-    const auto &indices  = mesh->indices;
-    const auto &vertices = mesh->vertices;
-    const auto &uvs      = mesh->uvs;
-
-    for (int32_t i = 0; i < indices.size(); i += 3) {
-        const auto a_ptr = I32(indices[i]);
-        const auto b_ptr = I32(indices[i + 1]);
-        const auto c_ptr = I32(indices[i + 2]);
-
-        const auto a_v_ptr  = a_ptr * 3;
-        const auto b_v_ptr  = b_ptr * 3;
-        const auto c_v_ptr  = c_ptr * 3;
-        const auto a_vt_ptr = a_ptr * 2;
-        const auto b_vt_ptr = b_ptr * 2;
-        const auto c_vt_ptr = c_ptr * 2;
-
-        glm::vec3 a_v  = {vertices[a_v_ptr], vertices[a_v_ptr + 1], vertices[a_v_ptr + 2]};
-        glm::vec3 a_vt = {uvs[a_vt_ptr], uvs[a_vt_ptr + 1], uvs[a_vt_ptr + 2]};
-
-        glm::vec3 b_v  = {vertices[b_v_ptr], vertices[b_v_ptr + 1], vertices[b_v_ptr + 2]};
-        glm::vec3 b_vt = {uvs[b_vt_ptr], uvs[b_vt_ptr + 1], uvs[b_vt_ptr + 2]};
-
-        glm::vec3 c_v  = {vertices[c_v_ptr], vertices[c_v_ptr + 1], vertices[c_v_ptr + 2]};
-        glm::vec3 c_vt = {uvs[c_vt_ptr], uvs[c_vt_ptr + 1], uvs[c_vt_ptr + 2]};
-
-        glm::vec3 norm = normalize(cross(b_v - a_v, c_v - a_v));
-
-        Vertex a = {a_v, norm, a_vt};
-        Vertex b = {b_v, norm, b_vt};
-        Vertex c = {c_v, norm, c_vt};
-
-        m_triangles.emplace_back(a, b, c);
-    }
-
-    for (auto &tri: m_triangles) {
-        auto tri_tex_min = m_lightmap_texture.to_pixel_coords(tri.tex_min);
-        auto tri_tex_max = m_lightmap_texture.to_pixel_coords(tri.tex_max);
-        for (int32_t y = tri_tex_min.y - 1; y <= tri_tex_max.y; ++y) {
-            for (int32_t  x = tri_tex_min.x - 1; x <= tri_tex_max.x; ++x) {
-                if (Patch patch{
-                    .pixel_coords{x, y},
-                    .normal = tri.a.normal,
-                }; tri.try_calculate_pt_from_uv(m_lightmap_texture.to_uv_coords(x, y), patch.world_coords)) {
-                    patch.world_coords += patch.normal * NEAR_CLIP;
-                    m_patches.push_back(patch);
-                }
-            }
+
+    const glm::vec3 sun_axis = normalize(-m_light_main_dir);
+    m_sun_disk = SunDisk(sun_axis, normalize(get_perp_vec(sun_axis)), glm::radians(SHADOW_ANGLE), config.seed);
+
+    // Padded so that patch origins, pushed off their surface by NEAR_CLIP, stay inside.
+    const glm::vec3 bounds_padding = glm::vec3(NEAR_CLIP * 2.0F) + (mesh->max - mesh->min) * 1e-3F;
+    m_bounds_min = mesh->min - bounds_padding;
+    m_bounds_max = mesh->max + bounds_padding;
+
+    /*
+     * Startup runs as a small dependency graph on the pool. The BVH build and chart labelling need only the mesh
+     * and are queued first; this thread generates patches meanwhile. Texel ownership is the first stage that
+     * needs charts and AO classification the first that needs the BVH, so each waits right there.
+     */
+    TaskGroup charts;
+    m_thread_pool.run(charts, [this](uint32_t) {
+        label_triangle_charts();
+    });
+
+    create_embree_scene();
+    TaskGroup         bvh_build;
+    std::atomic<bool> bvh_built = false;
+    commit_embree_scene(bvh_build, bvh_built);
+
+    std::vector<float> patch_depths;
+    std::vector<Patch> patches;
+    {
+        const TriangleStore triangles(*mesh, width, height, m_config.conservative_raster, m_thread_pool);
+        m_triangle_store_bytes = triangles.memory_bytes();
+        patches                = rasterize_patches(triangles, patch_depths);
+    }
+    m_thread_pool.wait(charts);
+    assign_texel_owners(width, height, patches, patch_depths);
+
+    // Patch order only decides which work items run together, never a texel's samples.
+    const auto patch_remap = m_config.morton_order
+                                 ? m_patches.build(patches, width, m_bounds_min, m_bounds_max)
+                                 : m_patches.build(patches, width);
+    for (auto &texel_patch: m_texel_patches) {
+        if (texel_patch != UINT32_MAX) {
+            texel_patch = patch_remap[texel_patch];
+        }
+    }
+
+    m_thread_pool.wait(bvh_build);
+
+    if (m_config.ao_culling) {
+        classify_ao_neighbourhoods();
+    }
+}
+
+/*
+ * Charts are the connected components of triangles that share vertices. Exported meshes often repeat a vertex per
+ * triangle, so vertices with the same position and lightmap UV are welded first; a UV seam keeps its two sides
+ * apart because their lightmap UVs differ.
+ */
+void Scene::label_triangle_charts() {
+    const auto &indices  = m_mesh->indices;
+    const auto &vertices = m_mesh->vertices;
+    const auto &uvs      = m_mesh->lightmap_uvs;
+
+    std::vector<uint32_t> vertex_parents(m_mesh->vertex_count());
+    std::iota(vertex_parents.begin(), vertex_parents.end(), 0);
+    const auto find_root = [&vertex_parents](uint32_t vertex) {
+        while (vertex_parents[vertex] != vertex) {
+            vertex = vertex_parents[vertex] = vertex_parents[vertex_parents[vertex]];
+        }
+        return vertex;
+    };
+    const auto unite = [&vertex_parents, &find_root](const uint32_t a, const uint32_t b) {
+        vertex_parents[find_root(b)] = find_root(a);
+    };
+
+    using WeldKey = std::array<float, 5>;
+    const auto weld_key = [&vertices, &uvs](const uint32_t vertex) {
+        return WeldKey{vertices[vertex * 3], vertices[vertex * 3 + 1], vertices[vertex * 3 + 2],
+                       uvs[vertex * 2], uvs[vertex * 2 + 1]};
+    };
+    std::vector<uint32_t> welded(vertex_parents.size());
+    std::iota(welded.begin(), welded.end(), 0);
+    std::ranges::sort(welded, {}, weld_key);
+    for (size_t i = 1; i < welded.size(); ++i) {
+        if (weld_key(welded[i - 1]) == weld_key(welded[i])) {
+            unite(welded[i - 1], welded[i]);
         }
     }
-    m_embree_device = rtcNewDevice(nullptr);
+
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        unite(indices[i], indices[i + 1]);
+        unite(indices[i], indices[i + 2]);
+    }
+    m_triangle_charts.resize(indices.size() / 3);
+    for (size_t ti = 0; ti < m_triangle_charts.size(); ++ti) {
+        m_triangle_charts[ti] = find_root(indices[ti * 3]);
+    }
+}
+
+void Scene::create_embree_scene() {
+    /*
+     * A cooperative build should run only on pool workers that join it. Under TBB, user_threads reserves that many
+     * arena slots for joining threads, so threads=user_threads leaves no slot for a TBB worker. Embree's internal
+     * tasking ignores user_threads and starts threads - 1 workers of its own, so there the device is recreated with
+     * a single thread, the minimum it accepts. Workers start lazily, so the first device costs no threads.
+     */
+    const uint32_t pool_threads = m_thread_pool.size();
+    const auto     new_device   = [this](const uint32_t threads, const uint32_t user_threads) {
+        std::string device_config = "threads=" + std::to_string(threads);
+        if (user_threads) {
+            device_config += ",user_threads=" + std::to_string(user_threads);
+        }
+        if (!m_config.embree_isa.empty()) {
+            device_config += ",isa=" + m_config.embree_isa;
+        }
+        return rtcNewDevice(device_config.c_str());
+    };
+    if (m_config.cooperative_bvh_build) {
+        m_embree_device = new_device(pool_threads, pool_threads);
+        assert(m_embree_device && "Unable to create embree device.");
+        if (rtcGetDeviceProperty(m_embree_device, RTC_DEVICE_PROPERTY_TASKING_SYSTEM) != EMBREE_TASKING_TBB) {
+            rtcReleaseDevice(m_embree_device);
+            m_embree_device = new_device(1, pool_threads);
+        }
+    } else {
+        m_embree_device = new_device(m_config.embree_threads, 0);
+    }
     assert(m_embree_device && "Unable to create embree device.");
+    rtcSetDeviceMemoryMonitorFunction(m_embree_device, embree_memory_monitor, this);
 
     m_embree_scene = rtcNewScene(m_embree_device);
     assert(m_embree_scene);
 
-    m_embree_mesh = rtcNewGeometry(m_embree_device, RTC_GEOMETRY_TYPE_TRIANGLE);
-    assert(mesh);
+    uint32_t scene_flags = RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS;
+    if (m_config.bvh_compact) {
+        scene_flags |= RTC_SCENE_FLAG_COMPACT;
+    }
+    if (m_config.bvh_robust) {
+        scene_flags |= RTC_SCENE_FLAG_ROBUST;
+    }
+    rtcSetSceneFlags(m_embree_scene, static_cast<RTCSceneFlags>(scene_flags));
+
+    const RTCBuildQuality quality = m_config.bvh_quality == BvhQuality::Low    ? RTC_BUILD_QUALITY_LOW
+                                    : m_config.bvh_quality == BvhQuality::High ? RTC_BUILD_QUALITY_HIGH
+                                                                               : RTC_BUILD_QUALITY_MEDIUM;
+    rtcSetSceneBuildQuality(m_embree_scene, quality);
 
-    auto *vertex_buffer = static_cast<float *>(rtcSetNewGeometryBuffer(m_embree_mesh, RTC_BUFFER_TYPE_VERTEX, 0,
-                                                                       RTC_FORMAT_FLOAT3, 3 * sizeof(float),
-                                                                       vertices.size() / 3));
-    memcpy(vertex_buffer, vertices.data(), vertices.size() * sizeof(float));
+    m_embree_mesh = rtcNewGeometry(m_embree_device, RTC_GEOMETRY_TYPE_TRIANGLE);
+    assert(m_embree_mesh);
+    rtcSetGeometryBuildQuality(m_embree_mesh, quality);
 
-    auto *index_buffer = static_cast<uint32_t *>(rtcSetNewGeometryBuffer(m_embree_mesh, RTC_BUFFER_TYPE_INDEX, 0,
-                                                                         RTC_FORMAT_UINT3, 3 * sizeof(uint32_t),
-                                                                         indices.size() / 3));
-    memcpy(index_buffer, indices.data(), indices.size() * sizeof(uint32_t));
+    // Embree reads straight from the mesh's own memory; MeshData keeps it alive and padded for the whole bake.
+    const auto &vertices = m_mesh->vertices;
+    const auto &indices  = m_mesh->indices;
+    rtcSetSharedGeometryBuffer(m_embree_mesh, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices.data(), 0,
+                               3 * sizeof(float), vertices.size() / 3);
+    rtcSetSharedGeometryBuffer(m_embree_mesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, indices.data(), 0,
+                               3 * sizeof(uint32_t), indices.size() / 3);
 
     rtcCommitGeometry(m_embree_mesh);
     rtcAttachGeometry(m_embree_scene, m_embree_mesh);
-    rtcCommitScene(m_embree_scene);
+}
+
+/*
+ * Queues the BVH build on the pool: every worker gets a task that joins the commit, and workers that pick one up
+ * after the build has finished skip it (one that races past the check commits an unmodified scene, a no-op).
+ * Whoever isn't in the build keeps working on other tasks, so patch generation overlaps it. Wait on group before
+ * tracing.
+ */
+void Scene::commit_embree_scene(TaskGroup &group, std::atomic<bool> &built) {
+    const auto start = std::chrono::steady_clock::now();
+    if (!m_config.cooperative_bvh_build) {
+        rtcCommitScene(m_embree_scene);
+        m_bvh_build_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        built.store(true, std::memory_order_release);
+        return;
+    }
+    for (uint32_t worker = 0; worker < m_thread_pool.size(); ++worker) {
+        m_thread_pool.run(group, [this, &built, start](uint32_t) {
+            if (built.load(std::memory_order_acquire)) {
+                return;
+            }
+            rtcJoinCommitScene(m_embree_scene);
+            if (!built.exchange(true, std::memory_order_acq_rel)) {
+                m_bvh_build_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        });
+    }
+}
+
+// Embree reports every device allocation (bytes > 0) and release (bytes < 0); returning false would deny it.
+bool Scene::embree_memory_monitor(void *scene, const ssize_t bytes, bool) {
+    auto *const   self    = static_cast<Scene *>(scene);
+    const int64_t current = self->m_bvh_bytes += bytes;
+    int64_t       peak    = self->m_bvh_peak_bytes.load(std::memory_order_relaxed);
+    while (current > peak && !self->m_bvh_peak_bytes.compare_exchange_weak(peak, current)) {
+    }
+    return true;
+}
+
+RTCOccludedArguments Scene::occluded_arguments(const RTCRayQueryFlags flags, const RTCFilterFunctionN filter) const {
+    RTCOccludedArguments args;
+    rtcInitOccludedArguments(&args);
+    args.flags = filter ? flags | RTC_RAY_QUERY_FLAG_INVOKE_ARGUMENT_FILTER : flags;
+    if (filter) {
+        args.filter = filter;
+    }
+    if (m_config.triangle_feature_mask) {
+        uint32_t feature_mask = RTC_FEATURE_FLAG_TRIANGLE;
+        if (filter) {
+            feature_mask |= RTC_FEATURE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS;
+        }
+        args.feature_mask = static_cast<RTCFeatureFlags>(feature_mask);
+    }
+    return args;
 }
 
 Scene::~Scene() {
@@ -148,69 +290,555 @@ Scene::~Scene() {
     rtcReleaseDevice(m_embree_device);
 }
 
-void Scene::load_albedo_from_file(const std::string &file_name) {
-    m_albedo_texture.load(file_name);
+std::vector<Patch> Scene::rasterize_patches(const TriangleStore &triangles, std::vector<float> &patch_depths) {
+    const auto triangle_count = triangles.size();
+
+    // Counting first lets every triangle write its patches straight into its own slice, in triangle order.
+    std::vector<uint32_t> patch_offsets(triangle_count + 1, 0);
+    m_thread_pool.parallel_for(triangle_count, RASTER_TRIANGLE_GRAIN,
+                               [&](const uint32_t begin, const uint32_t end, uint32_t) {
+                                   for (uint32_t ti = begin; ti < end; ++ti) {
+                                       patch_offsets[ti + 1] = triangles.rasterizer(ti).count();
+                                   }
+                               });
+    std::inclusive_scan(patch_offsets.begin(), patch_offsets.end(), patch_offsets.begin());
+    std::vector<Patch> patches(patch_offsets.back());
+    patch_depths.resize(patch_offsets.back());
+
+    m_thread_pool.parallel_for(triangle_count, RASTER_TRIANGLE_GRAIN,
+                               [&](const uint32_t begin, const uint32_t end, uint32_t) {
+                                   for (uint32_t ti = begin; ti < end; ++ti) {
+                                       const glm::vec3 a      = get_triangle_vertex(ti, 0);
+                                       const glm::vec3 b      = get_triangle_vertex(ti, 1);
+                                       const glm::vec3 c      = get_triangle_vertex(ti, 2);
+                                       const glm::vec3 offset = normalize(cross(b - a, c - a)) * NEAR_CLIP;
+                                       uint32_t        pi     = patch_offsets[ti];
+                                       triangles.rasterizer(ti).rasterize([&](const int32_t x, const int32_t y,
+                                                                              const glm::vec3 &barycentric,
+                                                                              const float depth) {
+                                           patch_depths[pi] = depth;
+                                           patches[pi++]    = Patch{
+                                               .pixel_coords{x, y},
+                                               .normal = triangles.normal(ti),
+                                               .world_coords = a * barycentric.x +
+                                                               b * barycentric.y +
+                                                               c * barycentric.z +
+                                                               offset,
+                                               .triangle = ti,
+                                               .flags = 0,
+                                           };
+                                       });
+                                   }
+                               });
+    return patches;
+}
+
+void Scene::assign_texel_owners(const uint32_t width, const uint32_t height, std::vector<Patch> &patches,
+                                const std::vector<float> &patch_depths) {
+    // The owner of a texel is the patch whose triangle reaches deepest around the texel centre; ties go to
+    // the earlier patch so the choice doesn't depend on thread count.
+    m_texel_patches.assign(static_cast<size_t>(width) * height, UINT32_MAX);
+    for (uint32_t pi = 0; pi < patches.size(); ++pi) {
+        const auto &pixel_coords = patches[pi].pixel_coords;
+        auto &      owner        = m_texel_patches[m_accumulation.index(pixel_coords.x, pixel_coords.y)];
+        if (owner == UINT32_MAX || patch_depths[pi] > patch_depths[owner]) {
+            owner = pi;
+        }
+    }
+
+    m_duplicate_patches = 0;
+    m_conflict_texels   = 0;
+    std::vector<uint8_t> conflicted(m_texel_patches.size(), 0);
+    for (uint32_t pi = 0; pi < patches.size(); ++pi) {
+        const auto &   pixel_coords = patches[pi].pixel_coords;
+        const uint32_t texel        = m_accumulation.index(pixel_coords.x, pixel_coords.y);
+        const uint32_t owner = m_texel_patches[texel];
+        if (owner == pi) {
+            continue;
+        }
+        m_duplicate_patches++;
+        /*
+         * Triangles of one chart meeting on a texel are just a shared edge. Different charts only conflict if
+         * the texel centre lies inside both: conservative raster also hands a chart the texels its border merely
+         * grazes, and neighbouring islands separated by less than a texel share those without overlapping.
+         */
+        if (m_triangle_charts[patches[pi].triangle] != m_triangle_charts[patches[owner].triangle] &&
+            patch_depths[pi] >= 0.0F && patch_depths[owner] >= 0.0F && !conflicted[texel]) {
+            conflicted[texel] = 1;
+            m_conflict_texels++;
+        }
+    }
+
+    if (!m_config.texel_ownership) {
+        return;
+    }
+    std::vector<Patch> owners;
+    owners.reserve(patches.size() - m_duplicate_patches);
+    for (auto &texel_patch: m_texel_patches) {
+        if (texel_patch != UINT32_MAX) {
+            owners.push_back(patches[texel_patch]);
+            texel_patch = static_cast<uint32_t>(owners.size() - 1);
+        }
+    }
+    patches = std::move(owners);
+}
+
+bool Scene::ao_proximity_query(RTCPointQueryFunctionArguments *args) {
+    auto *          query  = static_cast<ProximityQuery *>(args->userPtr);
+    const glm::vec3 origin = {args->query->x, args->query->y, args->query->z};
+    const glm::vec3 a      = query->scene->get_triangle_vertex(args->primID, 0);
+    const glm::vec3 b      = query->scene->get_triangle_vertex(args->primID, 1);
+    const glm::vec3 c      = query->scene->get_triangle_vertex(args->primID, 2);
+
+    // Hemisphere rays only reach points above the tangent plane.
+    if (std::max(dot(a - origin, query->normal), std::max(dot(b - origin, query->normal),
+                                                           dot(c - origin, query->normal))) <= 0.0F) {
+        return false;
+    }
+    if (length(closest_point_on_triangle(origin, a, b, c) - origin) > args->query->radius) {
+        return false;
+    }
+
+    query->occluder_found = true;
+    args->query->radius   = 0.0F;
+    return true;
+}
+
+void Scene::classify_ao_neighbourhoods() {
+    m_thread_pool.parallel_for(m_patches.size(), m_config.tile_size,
+                               [this](const uint32_t begin, const uint32_t end, uint32_t) {
+                                   for (uint32_t pi = begin; pi < end; ++pi) {
+                                       const glm::vec3 origin = m_patches.position(pi);
+
+                                       RTCPointQueryContext context;
+                                       rtcInitPointQueryContext(&context);
+
+                                       RTCPointQuery point_query;
+                                       point_query.x      = origin.x;
+                                       point_query.y      = origin.y;
+                                       point_query.z      = origin.z;
+                                       point_query.time   = 0.0F;
+                                       point_query.radius = AO_RADIUS;
+
+                                       ProximityQuery query{this, m_patches.normal(pi), false};
+                                       rtcPointQuery(m_embree_scene, &point_query, &context, ao_proximity_query,
+                                                     &query);
+                                       if (!query.occluder_found) {
+                                           m_patches.flags(pi) |= PATCH_FLAG_AO_FREE;
+                                       }
+                                   }
+                               });
+}
+
+/*
+ * Sun rays bypass the RayQueue that sorts AO rays. A texel's shadow rays share one origin and stay inside the
+ * SHADOW_ANGLE cone, so each packet of RAY_PACKET_SIZE is already as coherent as sorting could make it, and
+ * consecutive texels arrive in Morton order. Pooling them across texels would also break the occluder cache,
+ * which records the first blocker per call and probes it before the next texel of the chart traces anything.
+ */
+uint32_t Scene::trace_sun(const uint32_t patch_index, const uint32_t first, const int32_t ray_num,
+                          WorkerState &worker) const {
+    const glm::vec3 origin = m_patches.position(patch_index);
+    const uint32_t  texel  = m_patches.texel(patch_index);
+
+    OccluderContext occluder_context;
+    rtcInitRayQueryContext(&occluder_context.context);
+
+    RTCOccludedArguments sun_args = occluded_arguments(RTC_RAY_QUERY_FLAG_COHERENT,
+                                                       m_config.shadow_cache ? record_occluder : nullptr);
+    sun_args.context = &occluder_context.context;
+
+    const uint32_t chart       = m_triangle_charts[m_patches.triangle(patch_index)];
+    auto &         cache_entry = worker.shadow_cache[chart % SHADOW_CACHE_SIZE];
+    const bool     cached      = m_config.shadow_cache && cache_entry.chart == chart;
+    glm::vec3      cached_tri[3];
+    if (cached) {
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            cached_tri[corner] = get_triangle_vertex(cache_entry.prim, corner);
+        }
+    }
+
+    OcclusionPacket<> packet;
+    glm::vec3         dirs[RAY_PACKET_SIZE];
+    uint32_t          occluded_num = 0;
+    for (int32_t offset = 0; offset < ray_num; offset += RAY_PACKET_SIZE) {
+        const auto count = static_cast<uint32_t>(std::min(ray_num - offset, RAY_PACKET_SIZE));
+        m_sun_disk.generate(texel, first + static_cast<uint32_t>(offset), count, dirs);
+        for (uint32_t i = 0; i < count; ++i) {
+            const float tfar = exit_distance(origin, dirs[i], m_bounds_min, m_bounds_max);
+            // The cached test only accepts clear interior hits that Embree would report as well, so the count
+            // doesn't depend on which chart a worker's cache happened to see last, nor on the thread count.
+            if (cached && intersects_triangle(origin, dirs[i], cached_tri[0], cached_tri[1],
+                                              cached_tri[2], NEAR_CLIP, tfar)) {
+                occluded_num++;
+                worker.shadow_cache_hits++;
+                continue;
+            }
+            packet.push(origin, dirs[i], NEAR_CLIP, tfar);
+        }
+        occluded_num += embree_occluded(packet, &sun_args);
+    }
+    worker.shadow_rays += ray_num;
+
+    if (occluder_context.prim != RTC_INVALID_GEOMETRY_ID) {
+        cache_entry = {chart, occluder_context.prim};
+    }
+    return occluded_num;
+}
+
+/*
+ * Traces the sun at a lattice of texels SHADOW_BLOCK_SIZE apart. Where all four corners of a block lie on the same
+ * chart and agree on being fully lit or fully in umbra, the block's texels of that chart take the corner result
+ * and trace no shadow rays of their own; only blocks near shadow boundaries are sampled per texel.
+ */
+void Scene::classify_shadow_blocks() {
+    const uint32_t width          = m_accumulation.width();
+    const uint32_t height         = m_accumulation.height();
+    const uint32_t lattice_width  = (width + SHADOW_BLOCK_SIZE - 1) / SHADOW_BLOCK_SIZE + 1;
+    const uint32_t lattice_height = (height + SHADOW_BLOCK_SIZE - 1) / SHADOW_BLOCK_SIZE + 1;
+
+    std::vector<ShadowBlock> lattice(lattice_width * lattice_height);
+    m_thread_pool.parallel_for(lattice_width * lattice_height, m_config.tile_size,
+                               [&](const uint32_t begin, const uint32_t end, const uint32_t worker) {
+                                   for (uint32_t li = begin; li < end; ++li) {
+                                       const uint32_t x  = std::min(li % lattice_width * SHADOW_BLOCK_SIZE, width - 1);
+                                       const uint32_t y  = std::min(li / lattice_width * SHADOW_BLOCK_SIZE, height - 1);
+                                       const uint32_t pi = m_texel_patches[m_accumulation.index(x, y)];
+                                       if (pi == UINT32_MAX ||
+                                           dot(m_patches.normal(pi), -m_light_main_dir) <= 0.0F) {
+                                           continue;
+                                       }
+                                       const uint32_t occluded_num = trace_sun(pi, 0, SHADOW_PREPASS_SAMPLES,
+                                                                               m_workers[worker]);
+                                       lattice[li].chart  = m_triangle_charts[m_patches.triangle(pi)];
+                                       lattice[li].normal = m_patches.normal(pi);
+                                       lattice[li].state  = occluded_num == 0
+                                                               ? ShadowState::Lit
+                                                               : occluded_num == SHADOW_PREPASS_SAMPLES
+                                                                     ? ShadowState::Umbra
+                                                                     : ShadowState::Penumbra;
+                                   }
+                               });
+
+    m_thread_pool.parallel_for(m_patches.size(), m_config.tile_size,
+                               [&](const uint32_t begin, const uint32_t end, uint32_t) {
+                                   for (uint32_t pi = begin; pi < end; ++pi) {
+                                       auto &flags = m_patches.flags(pi);
+                                       flags &= ~(PATCH_FLAG_SHADOW_LIT | PATCH_FLAG_SHADOW_UMBRA);
+
+                                       const glm::ivec2 pixel_coords = m_patches.pixel_coords(pi);
+                                       const uint32_t   bx           = pixel_coords.x / SHADOW_BLOCK_SIZE;
+                                       const uint32_t   by           = pixel_coords.y / SHADOW_BLOCK_SIZE;
+                                       const uint32_t   chart        = m_triangle_charts[m_patches.triangle(pi)];
+                                       const glm::vec3  normal       = m_patches.normal(pi);
+                                       const auto &     corner       = lattice[by * lattice_width + bx];
+                                       if (corner.state != ShadowState::Lit && corner.state != ShadowState::Umbra) {
+                                           continue;
+                                       }
+
+                                       /*
+                                        * A block spans triangle edges only within one chart, and only while it
+                                        * stays flat: past a crease the corners say nothing about the inside.
+                                        */
+                                       bool agree = true;
+                                       for (const uint32_t li: {by * lattice_width + bx,
+                                                                by * lattice_width + bx + 1,
+                                                                (by + 1) * lattice_width + bx,
+                                                                (by + 1) * lattice_width + bx + 1}) {
+                                           agree = agree && lattice[li].chart == chart &&
+                                                   lattice[li].state == corner.state &&
+                                                   dot(lattice[li].normal, normal) >= SHADOW_BLOCK_MIN_COS;
+                                       }
+                                       if (agree) {
+                                           flags |= corner.state == ShadowState::Lit
+                                                        ? PATCH_FLAG_SHADOW_LIT
+                                                        : PATCH_FLAG_SHADOW_UMBRA;
+                                       }
+                                   }
+                               });
+}
+
+float Scene::trace_ao(const uint32_t patch_index, WorkerState &worker, const uint32_t ray_scale) const {
+    const glm::vec3 normal     = m_patches.normal(patch_index);
+    const glm::vec3 ray_origin = m_patches.position(patch_index);
+    const uint32_t  texel      = m_patches.texel(patch_index);
+    const uint32_t  units      = m_patch_sample_units[patch_index];
+
+    RTCOccludedArguments ao_args = occluded_arguments(RTC_RAY_QUERY_FLAG_INCOHERENT);
+
+    const int32_t ao_ray_num = m_rays_per_texel * I32(ray_scale);
+
+    OcclusionPacket<> packet;
+    float             u[RAY_PACKET_SIZE], v[RAY_PACKET_SIZE];
+    glm::vec3         dirs[RAY_PACKET_SIZE];
+
+    worker.ao_rays += ao_ray_num;
+    float occluded_num = 0.0F;
+    for (int32_t first = 0; first < ao_ray_num; first += RAY_PACKET_SIZE) {
+        const auto count = static_cast<uint32_t>(std::min(ao_ray_num - first, RAY_PACKET_SIZE));
+        m_sampler->generate(texel, 0, units * m_rays_per_texel + static_cast<uint32_t>(first), count, u, v);
+        get_cos_hemisphere_samples(normal, u, v, count, dirs);
+        for (uint32_t i = 0; i < count; ++i) {
+            packet.push(ray_origin, dirs[i], NEAR_CLIP, AO_RADIUS);
+        }
+        occluded_num += static_cast<float>(embree_occluded(packet, &ao_args));
+    }
+    return 1.0F - occluded_num / static_cast<float>(ao_ray_num);
+}
+
+// Same rays as trace_ao(), but gathered from a run of patches and traced through the worker's sorting queue.
+void Scene::trace_ao_binned(const uint32_t *patch_indices, const uint32_t count, WorkerState &worker,
+                            const uint32_t ray_scale, float *visibility) const {
+    RTCOccludedArguments ao_args = occluded_arguments(RTC_RAY_QUERY_FLAG_COHERENT);
+
+    const int32_t   ao_ray_num = m_rays_per_texel * I32(ray_scale);
+    const glm::vec3 extent     = m_bounds_max - m_bounds_min;
+    auto &          occluded   = worker.ao_occluded;
+    occluded.assign(count, 0);
+    const auto flush = [&] {
+        worker.ray_queue.flush(m_embree_scene, &ao_args, m_bounds_min, extent, NEAR_CLIP, AO_RADIUS,
+                               [&occluded](const uint32_t slot) {
+                                   occluded[slot]++;
+                               });
+    };
+
+    float     u[RAY_PACKET_SIZE], v[RAY_PACKET_SIZE];
+    glm::vec3 dirs[RAY_PACKET_SIZE];
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        const uint32_t patch_index = patch_indices[slot];
+        if (m_patches.flags(patch_index) & PATCH_FLAG_AO_FREE) {
+            continue;
+        }
+        const glm::vec3 normal     = m_patches.normal(patch_index);
+        const glm::vec3 ray_origin = m_patches.position(patch_index);
+        const uint32_t  texel      = m_patches.texel(patch_index);
+        const uint32_t  units      = m_patch_sample_units[patch_index];
+        worker.ao_rays += ao_ray_num;
+        for (int32_t first = 0; first < ao_ray_num; first += RAY_PACKET_SIZE) {
+            const auto ray_count = static_cast<uint32_t>(std::min(ao_ray_num - first, RAY_PACKET_SIZE));
+            // Checked per packet rather than per texel, so a texel with more rays than the queue holds is split
+            // across flushes instead of overrunning the ray index bits.
+            if (!worker.ray_queue.fits(ray_count)) {
+                flush();
+            }
+            m_sampler->generate(texel, 0, units * m_rays_per_texel + static_cast<uint32_t>(first), ray_count, u, v);
+            get_cos_hemisphere_samples(normal, u, v, ray_count, dirs);
+            for (uint32_t i = 0; i < ray_count; ++i) {
+                worker.ray_queue.push(ray_origin, dirs[i], slot);
+            }
+        }
+    }
+    flush();
+
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        visibility[slot] = m_patches.flags(patch_indices[slot]) & PATCH_FLAG_AO_FREE
+                               ? 1.0F
+                               : 1.0F - static_cast<float>(occluded[slot]) / static_cast<float>(ao_ray_num);
+    }
+}
+
+float Scene::bake_patch(const uint32_t patch_index, WorkerState &worker, const uint32_t ray_scale,
+                        const float ao_visibility) const {
+    const glm::vec3 normal = m_patches.normal(patch_index);
+    const uint32_t  flags  = m_patches.flags(patch_index);
+    const uint32_t  units  = m_patch_sample_units[patch_index];
+
+    const int32_t shadow_ray_num = DIR_SAMPLES * I32(ray_scale);
+
+    // Back-facing texels get no direct light, so their shadow rays would be thrown away.
+    const float diffuse       = std::max(dot(normal, -m_light_main_dir), 0.0F);
+    float       shadow_factor = 0.0F;
+    if (flags & PATCH_FLAG_SHADOW_LIT) {
+        shadow_factor = 1.0F;
+    } else if (diffuse > 0.0F && !(flags & PATCH_FLAG_SHADOW_UMBRA)) {
+        const uint32_t occluded_num = trace_sun(patch_index, units * DIR_SAMPLES, shadow_ray_num, worker);
+        shadow_factor = 1.0F - static_cast<float>(occluded_num) / static_cast<float>(shadow_ray_num);
+    }
+    return ao_visibility * (shadow_factor * diffuse + AMBIENT_INTENSITY);
+}
+
+// Rays bake_patch() traces for the patch per unit of ray scale; AO-free and shadow-resolved patches skip theirs.
+uint32_t Scene::patch_ray_cost(const uint32_t patch_index) const {
+    const uint32_t flags = m_patches.flags(patch_index);
+    uint32_t       cost  = flags & PATCH_FLAG_AO_FREE ? 0 : static_cast<uint32_t>(m_rays_per_texel);
+    if (!(flags & (PATCH_FLAG_SHADOW_LIT | PATCH_FLAG_SHADOW_UMBRA)) &&
+        dot(m_patches.normal(patch_index), -m_light_main_dir) > 0.0F) {
+        cost += DIR_SAMPLES;
+    }
+    return cost;
+}
+
+void Scene::bake_tile(const uint32_t *patch_indices, const uint32_t count, WorkerState &worker,
+                      const uint32_t ray_scale) {
+    auto &visibility = worker.ao_visibility;
+    visibility.assign(count, 1.0F);
+    if (m_config.ray_binning) {
+        trace_ao_binned(patch_indices, count, worker, ray_scale, visibility.data());
+    } else {
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            if (!(m_patches.flags(patch_indices[slot]) & PATCH_FLAG_AO_FREE)) {
+                visibility[slot] = trace_ao(patch_indices[slot], worker, ray_scale);
+            }
+        }
+    }
+
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        const uint32_t pi    = patch_indices[slot];
+        const float    light = bake_patch(pi, worker, ray_scale, visibility[slot]);
+        // An owned texel is baked by exactly one patch, so no other tile writes to it in this pass.
+        if (m_config.texel_ownership) {
+            m_accumulation.add(m_patches.texel(pi), light, static_cast<float>(ray_scale));
+        } else {
+            m_patch_light[pi] = light;
+        }
+        m_patch_sample_units[pi] += ray_scale;
+    }
 }
 
 void Scene::bake() {
-    static glm::vec4 result_col;
-    const float smoothness = std::sin(glm::radians(SHADOW_ANGLE));
-    for (int32_t iter = 0; iter < ITER_NUM; ++iter) {
-        auto denom = static_cast<float>(iter);
-        for (auto &[pixel_coords, normal, ray_origin]: m_patches) {
-            float total_occlusion = 0.0F;
-            for (int32_t ri = 0; ri < m_rays_per_texel; ri++) {
-                auto ray_dir = normalize(get_cos_hemisphere_sample(normal));
-
-                if (dot(ray_dir, normal) < 0.0F) {
-                    ray_dir = -ray_dir;
-                }
+    const uint32_t patch_count = m_patches.size();
+    m_patch_light.resize(m_config.texel_ownership ? 0 : patch_count);
+    m_patch_sample_units.assign(patch_count, 0);
+    m_accumulation.clear();
+    m_stats = {};
+    m_stats.duplicate_patches    = m_duplicate_patches;
+    m_stats.conflict_texels      = m_conflict_texels;
+    m_stats.bvh_bytes            = m_bvh_bytes;
+    m_stats.bvh_peak_bytes       = m_bvh_peak_bytes;
+    m_stats.bvh_build_seconds    = m_bvh_build_seconds;
+    m_stats.triangle_store_bytes = m_triangle_store_bytes;
+    for (auto &worker: m_workers) {
+        worker = {};
+    }
 
-                if (auto [ray, hit] = embree_raycast(ray_origin, ray_dir, NEAR_CLIP, AO_RADIUS); OCCLUDED(hit.geomID)) {
-                    total_occlusion++;
-                }
+    if (m_config.shadow_blocks) {
+        classify_shadow_blocks();
+    }
+
+    std::vector<uint32_t> active_patches(patch_count);
+    std::iota(active_patches.begin(), active_patches.end(), 0);
+    const auto ray_cost = [this](const std::vector<uint32_t> &patches) {
+        uint64_t cost = 0;
+        for (const uint32_t pi: patches) {
+            cost += patch_ray_cost(pi);
+        }
+        return cost;
+    };
+    // A pass never traces more rays than the first, uniform one, so adaptive sampling costs at most a uniform bake.
+    const uint64_t pass_budget = m_config.adaptive_sampling ? ray_cost(active_patches) : 0;
+    uint32_t       ray_scale   = 1;
+    for (int32_t iter = 0; iter < ITER_NUM && !active_patches.empty(); ++iter) {
+        m_thread_pool.parallel_for(static_cast<uint32_t>(active_patches.size()), m_config.tile_size,
+                                   [this, &active_patches, ray_scale](const uint32_t begin, const uint32_t end,
+                                                                      const uint32_t worker) {
+                                       bake_tile(&active_patches[begin], end - begin, m_workers[worker], ray_scale);
+                                   });
+
+        // Without texel ownership patches of neighbouring triangles may share a texel, so the write-back stays serial.
+        if (!m_config.texel_ownership) {
+            for (const uint32_t pi: active_patches) {
+                m_accumulation.add(m_patches.texel(pi), m_patch_light[pi], static_cast<float>(ray_scale));
             }
-            total_occlusion = 1.0F - total_occlusion / static_cast<float>(m_rays_per_texel);
-            float occlusion = 0.0F;
-            for (int i = 0; i < DIR_SAMPLES; ++i) {
-                glm::vec3 light_dir = m_light_main_dir + glm::vec3(
-                                                                   (random_floats(random_engine) * 2.0F - 1.0F) * smoothness,
-                                                                   random_floats(random_engine) * smoothness,
-                                                                   (random_floats(random_engine) * 2.0F - 1.0F) * smoothness
-                                                                  );
-                light_dir = normalize(light_dir);
-
-                if (OCCLUDED(embree_raycast(ray_origin, -light_dir, NEAR_CLIP, FLT_MAX).hit.geomID)) {
-                    occlusion++;
-                }
+        }
+        m_stats.passes++;
+
+        if (m_config.adaptive_sampling && iter + 1 >= I32(m_config.adaptive_min_passes)) {
+            std::erase_if(active_patches, [this](const uint32_t pi) {
+                return m_accumulation.error(m_patches.texel(pi)) <= m_config.adaptive_error_threshold;
+            });
+            // Rays freed by converged texels go to the ones that are still noisy. The budget counts traced rays,
+            // not texels, since AO-free and shadow-resolved texels never had rays to give away.
+            if (const uint64_t active_cost = ray_cost(active_patches); active_cost > 0) {
+                ray_scale = static_cast<uint32_t>(std::clamp<uint64_t>(
+                    pass_budget / active_cost, 1, std::max(m_config.adaptive_max_ray_scale, 1U)));
             }
-            float diffuse       = std::max(dot(normal, -m_light_main_dir), 0.0F);
-            float shadow_factor = 1.0F - occlusion / DIR_SAMPLES;
-            total_occlusion *= shadow_factor * diffuse + AMBIENT_INTENSITY;
-            auto delta_col = glm::vec4{total_occlusion, total_occlusion, total_occlusion, 1.0F};
-
-            glm::vec4 total_col;
-            m_lightmap_texture.get_pixel(pixel_coords.x, pixel_coords.y, total_col);
-            m_lightmap_texture.set_pixel(pixel_coords.x, pixel_coords.y,
-                                         clamp((denom * total_col + delta_col) / (denom + 1), zero, one));
-        }
-        m_lightmap_texture.apply();
-    }
-
-    for (int32_t pass = 0; pass < ANTIALIAS_PASS_NUM; ++pass) {
-        for (int32_t y = 0; y < m_lightmap_texture.height(); ++y) {
-            for (int32_t      x = 0; x < m_lightmap_texture.width(); ++x) {
-                if (glm::vec4 base_col; m_lightmap_texture.get_pixel(x, y, base_col) &&
-                                        base_col.a < 1.0F) {
-                    result_col = {};
-                    m_lightmap_texture.antialias(x, y, result_col, 0.0F);
-                    m_lightmap_texture.set_pixel(x, y, result_col);
+        }
+    }
+    m_stats.ao_free_patches = m_patches.count_flags(PATCH_FLAG_AO_FREE);
+    m_stats.shadow_resolved = m_patches.count_flags(PATCH_FLAG_SHADOW_LIT | PATCH_FLAG_SHADOW_UMBRA);
+    m_stats.converged  = patch_count - static_cast<uint32_t>(active_patches.size());
+    m_stats.mean_error = m_accumulation.mean_error();
+    for (const auto &worker: m_workers) {
+        m_stats.ao_rays += worker.ao_rays;
+        m_stats.shadow_rays += worker.shadow_rays;
+        m_stats.shadow_cache_hits += worker.shadow_cache_hits;
+    }
+    m_accumulation.resolve(m_lightmap, m_config.srgb_output ? ColorEncoding::Srgb : ColorEncoding::Linear);
+    dilate_lightmap();
+}
+
+/*
+ * Fills texels no patch covers from the nearest baked texels, so bilinear lookups near chart edges don't pick up
+ * black. Each gutter texel averages the nearest seeds of its 3x3 neighbourhood; in chart-aware mode only seeds of
+ * the same chart as its own nearest seed count, so a gutter between two islands never blends them. A chart is a
+ * whole welded UV island, so seeds from different triangles of one island still blend.
+ */
+void Scene::dilate_lightmap() {
+    const uint32_t width  = m_accumulation.width();
+    const uint32_t height = m_accumulation.height();
+
+    std::vector<uint8_t>  seeds(static_cast<size_t>(width) * height);
+    std::vector<uint32_t> seed_charts(seeds.size(), UINT32_MAX);
+    for (uint32_t texel = 0; texel < seeds.size(); ++texel) {
+        seeds[texel] = m_accumulation.count(texel) > 0 ? 1 : 0;
+        if (seeds[texel]) {
+            seed_charts[texel] = m_triangle_charts[m_patches.triangle(m_texel_patches[texel])];
+        }
+    }
+    const std::vector<uint32_t> nearest = jump_flood(seeds, width, height, m_thread_pool);
+
+    const auto chart_of = [&seed_charts](const uint32_t seed) {
+        return seed_charts[seed];
+    };
+    const auto in_reach = [this, width](const uint32_t texel, const uint32_t seed) {
+        if (m_config.dilation_radius == 0) {
+            return true;
+        }
+        const int64_t dx = static_cast<int64_t>(texel % width) - static_cast<int64_t>(seed % width);
+        const int64_t dy = static_cast<int64_t>(texel / width) - static_cast<int64_t>(seed / width);
+        return dx * dx + dy * dy <= static_cast<int64_t>(m_config.dilation_radius) * m_config.dilation_radius;
+    };
+
+    m_thread_pool.parallel_for(height, JUMP_FLOOD_ROW_GRAIN, [&](const uint32_t begin, const uint32_t end, uint32_t) {
+        for (uint32_t y = begin; y < end; ++y) {
+            for (uint32_t x = 0; x < width; ++x) {
+                const uint32_t texel = y * width + x;
+                const uint32_t own   = nearest[texel];
+                if (seeds[texel] || own == JUMP_FLOOD_NONE || !in_reach(texel, own)) {
+                    continue;
                 }
+
+                const uint32_t chart = chart_of(own);
+                glm::vec4      sum{};
+                float          weight = 0.0F;
+                for (int32_t dy = -1; dy <= 1; ++dy) {
+                    for (int32_t dx = -1; dx <= 1; ++dx) {
+                        const int32_t nx = I32(x) + dx;
+                        const int32_t ny = I32(y) + dy;
+                        if (!m_accumulation.contains(nx, ny)) {
+                            continue;
+                        }
+                        const uint32_t seed = nearest[m_accumulation.index(nx, ny)];
+                        if (seed == JUMP_FLOOD_NONE || !in_reach(texel, seed) ||
+                            (m_config.chart_aware_dilation && chart_of(seed) != chart)) {
+                            continue;
+                        }
+                        glm::vec4 color{};
+                        m_lightmap.get_pixel(I32(seed % width), I32(seed / width), color);
+                        sum += color;
+                        weight += 1.0F;
+                    }
+                }
+                sum /= weight;
+                sum.a = 1.0F;
+                m_lightmap.set_pixel(I32(x), I32(y), sum);
             }
         }
-        m_lightmap_texture.apply();
-    }
-    /*
-     * m_lightmap_texture.save("path\\to\\output\\lightmap");
-     */
+    });
+    m_lightmap.flush();
+}
+
+void Scene::save_variance_map(const std::string &file_name) const {
+    lodepng::encode(file_name, m_accumulation.error_image(m_config.adaptive_error_threshold * 4.0F),
+                    m_accumulation.width(), m_accumulation.height());
 }
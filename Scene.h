@@ -4,12 +4,22 @@
 
 #ifndef SCENE_H
 #define SCENE_H
-#include <random>
-
-#include "Mesh.h"
-#include "Shader.h"
-#include "Texture.h"
-#include "Triangle.h"
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <numeric>
+
+#include "AccumulationBuffer.h"
+#include "BakeConfig.h"
+#include "Image.h"
+#include "JumpFlood.h"
+#include "MeshData.h"
+#include "PatchStore.h"
+#include "RayQueue.h"
+#include "SunDisk.h"
+#include "ThreadPool.h"
+#include "TriangleStore.h"
+#include "Visibility.h"
 
 #include <embree4/rtcore.h>
 #include <bits/stl_algo.h>
@@ -22,16 +32,50 @@
 #define DIR_SAMPLES           32
 #define SHADOW_ANGLE          30.0F
 #define AO_RADIUS             1.0F
-#define ANTIALIAS_PASS_NUM    3
 #define NEAR_CLIP             0.01F
 
+#define RASTER_TRIANGLE_GRAIN  1024
+
+#define SHADOW_BLOCK_SIZE      4
+#define SHADOW_PREPASS_SAMPLES 64
+#define SHADOW_BLOCK_MIN_COS   0.999F
+
+#define EMBREE_TASKING_TBB     1 // RTC_DEVICE_PROPERTY_TASKING_SYSTEM value of a TBB build
+
+#define PATCH_FLAG_AO_FREE      (1U << 0)
+#define PATCH_FLAG_SHADOW_LIT   (1U << 1)
+#define PATCH_FLAG_SHADOW_UMBRA (1U << 2)
+
 constexpr glm::vec4 zero = {0.0F, 0.0F, 0.0F, 0.0F};
 constexpr glm::vec4 one  = {1.0F, 1.0F, 1.0F, 1.0F};
 
-struct Patch final {
-    glm::ivec2 pixel_coords;
-    glm::vec3  normal;
-    glm::vec3  world_coords;
+struct ProximityQuery final {
+    const class Scene *scene;
+    glm::vec3          normal;
+    bool               occluder_found;
+};
+
+enum class ShadowState : uint8_t {
+    Unknown,
+    Lit,
+    Umbra,
+    Penumbra
+};
+
+struct ShadowBlock final {
+    ShadowState state  = ShadowState::Unknown;
+    uint32_t    chart  = RTC_INVALID_GEOMETRY_ID;
+    glm::vec3   normal{};
+};
+
+struct WorkerState final {
+    ShadowCache           shadow_cache;
+    RayQueue              ray_queue;
+    std::vector<uint32_t> ao_occluded;
+    std::vector<float>    ao_visibility;
+    uint64_t              ao_rays           = 0;
+    uint64_t              shadow_rays       = 0;
+    uint64_t              shadow_cache_hits = 0;
 };
 
 class Scene final {
@@ -39,47 +83,83 @@ class Scene final {
     RTCScene    m_embree_scene;
     RTCGeometry m_embree_mesh;
 
-    std::mt19937                          random_engine;
-    std::uniform_real_distribution<float> random_floats;
+    BakeConfig               m_config;
+    BakeStats                m_stats;
+    ThreadPool               m_thread_pool;
+    std::vector<WorkerState> m_workers;
+    std::unique_ptr<Sampler> m_sampler;
 
-    Mesh *m_mesh;
+    const MeshData *m_mesh;
 
-    Texture m_lightmap_texture;
-    Texture m_albedo_texture;
+    Image              m_lightmap;
+    AccumulationBuffer m_accumulation;
 
     int32_t m_rays_per_texel;
 
     glm::vec3 m_light_main_dir;
-
-    std::vector<Patch>    m_patches;
-    std::vector<Triangle> m_triangles;
-
-    [[nodiscard]] glm::vec3 get_cos_hemisphere_sample(const glm::vec3& normal);
-    [[nodiscard]] RTCRayHit embree_raycast(const glm::vec3 &ray_origin, const glm::vec3 &ray_dir, const float &tmin, const float &tmax) const;
+    SunDisk   m_sun_disk;
+    glm::vec3 m_bounds_min, m_bounds_max;
+
+    PatchStore            m_patches;
+    std::vector<uint32_t> m_texel_patches;
+    uint32_t              m_duplicate_patches = 0;
+    uint32_t              m_conflict_texels   = 0;
+    std::vector<float>    m_patch_light;
+    std::vector<uint32_t> m_patch_sample_units;
+    std::vector<uint32_t> m_triangle_charts;
+
+    std::atomic<int64_t> m_bvh_bytes            = 0;
+    std::atomic<int64_t> m_bvh_peak_bytes       = 0;
+    double               m_bvh_build_seconds    = 0.0;
+    size_t               m_triangle_store_bytes = 0;
+
+    static void get_cos_hemisphere_samples(const glm::vec3 &normal, const float *u, const float *v, uint32_t count, glm::vec3 *dirs);
+    [[nodiscard]] uint32_t embree_occluded(OcclusionPacket<> &packet, RTCOccludedArguments *args) const;
     [[nodiscard]] static glm::vec3 get_perp_vec(const glm::vec3& u);
     [[nodiscard]] static glm::vec3 project_on_plane(const glm::vec3 &normal, const glm::vec3 &pt);
+    [[nodiscard]] glm::vec3 get_triangle_vertex(uint32_t triangle, uint32_t corner) const;
     [[nodiscard]] static glm::vec4 lerp_rgba(const glm::vec4 &a, const glm::vec4 &b, float t);
+
+    [[nodiscard]] std::vector<Patch> rasterize_patches(const TriangleStore &triangles, std::vector<float> &patch_depths);
+    void assign_texel_owners(uint32_t width, uint32_t height, std::vector<Patch> &patches,
+                             const std::vector<float> &patch_depths);
+
+    void label_triangle_charts();
+    void create_embree_scene();
+    void commit_embree_scene(TaskGroup &group, std::atomic<bool> &built);
+    [[nodiscard]] static bool embree_memory_monitor(void *scene, ssize_t bytes, bool post);
+    [[nodiscard]] RTCOccludedArguments occluded_arguments(RTCRayQueryFlags flags, RTCFilterFunctionN filter = nullptr) const;
+
+    [[nodiscard]] static bool ao_proximity_query(RTCPointQueryFunctionArguments *args);
+    void classify_ao_neighbourhoods();
+
+    [[nodiscard]] uint32_t trace_sun(uint32_t patch_index, uint32_t first, int32_t ray_num, WorkerState &worker) const;
+    void classify_shadow_blocks();
+
+    [[nodiscard]] float trace_ao(uint32_t patch_index, WorkerState &worker, uint32_t ray_scale) const;
+    void trace_ao_binned(const uint32_t *patch_indices, uint32_t count, WorkerState &worker, uint32_t ray_scale,
+                         float *visibility) const;
+    [[nodiscard]] float bake_patch(uint32_t patch_index, WorkerState &worker, uint32_t ray_scale,
+                                   float ao_visibility) const;
+    [[nodiscard]] uint32_t patch_ray_cost(uint32_t patch_index) const;
+    void bake_tile(const uint32_t *patch_indices, uint32_t count, WorkerState &worker, uint32_t ray_scale);
+    void dilate_lightmap();
 public:
     Scene(
-        const glm::vec3 &                   light_dir,
-        Mesh *                              mesh,
-        int32_t                             rays_per_texel,
-        uint32_t                            width      = LIGHTMAP_SIZE,
-        uint32_t                            height     = LIGHTMAP_SIZE,
-        std::initializer_list<TexParameter> parameters = {
-            TexParameter{GL_TEXTURE_MIN_FILTER, GL_LINEAR},
-            TexParameter{GL_TEXTURE_MAG_FILTER, GL_LINEAR},
-            TexParameter{GL_TEXTURE_WRAP_S, GL_REPEAT},
-            TexParameter{GL_TEXTURE_WRAP_T, GL_REPEAT}
-        });
+        const glm::vec3 & light_dir,
+        const MeshData *  mesh,
+        int32_t           rays_per_texel,
+        const BakeConfig &config = {},
+        uint32_t          width  = LIGHTMAP_SIZE,
+        uint32_t          height = LIGHTMAP_SIZE);
 
     ~Scene();
 
-    const Texture &lightmap_texture = m_lightmap_texture;
-    const Texture &albedo_texture   = m_albedo_texture;
+    const Image &    lightmap = m_lightmap;
+    const BakeStats &stats    = m_stats;
 
-    void load_albedo_from_file(const std::string &file_name);
     void bake();
+    void save_variance_map(const std::string &file_name) const;
 };
 
 
@@ -0,0 +1,83 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef SUNDISK_H
+#define SUNDISK_H
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Random.h"
+#include <glm.hpp>
+
+#define SUN_TABLE_SIZE    256
+#define SUN_TABLE_STRATUM 32
+
+/*
+ * Shared table of directions uniformly distributed over the sun cone, stored in the cone's local frame.
+ * A texel walks the table from a per-texel offset and spins it around the cone axis by a per-texel angle,
+ * so shadow rays need no RNG call or normalize in the bake loop.
+ */
+class SunDisk final {
+    std::vector<float> m_x, m_y, m_z;
+    glm::vec3          m_axis{}, m_tan{}, m_bitan{};
+    uint32_t           m_seed = 0;
+
+public:
+    SunDisk() = default;
+
+    SunDisk(const glm::vec3 &axis, const glm::vec3 &tan, const float half_angle, const uint32_t seed) :
+        m_x(SUN_TABLE_SIZE),
+        m_y(SUN_TABLE_SIZE),
+        m_z(SUN_TABLE_SIZE),
+        m_axis(axis),
+        m_tan(tan),
+        m_bitan(cross(axis, tan)),
+        m_seed(seed) {
+        // First two Sobol dimensions, so every aligned run of SUN_TABLE_STRATUM entries is stratified on its own.
+        const float cos_max = std::cos(half_angle);
+        for (uint32_t i = 0; i < SUN_TABLE_SIZE; ++i) {
+            uint32_t bits_u = 0, bits_v = 0;
+            for (uint32_t bit = 0, direction = 1U << 31; bit < 32; ++bit, direction ^= direction >> 1) {
+                if (i >> bit & 1U) {
+                    bits_u |= 1U << (31 - bit);
+                    bits_v ^= direction;
+                }
+            }
+
+            const float u         = static_cast<float>(bits_u >> 8) * 0x1p-24F;
+            const float v         = static_cast<float>(bits_v >> 8) * 0x1p-24F;
+            const float cos_theta = 1.0F - u * (1.0F - cos_max);
+            const float sin_theta = std::sqrt(std::max(1.0F - cos_theta * cos_theta, 0.0F));
+            const float phi       = 2.0F * 3.14159265F * v;
+            m_x[i]                = sin_theta * std::cos(phi);
+            m_y[i]                = sin_theta * std::sin(phi);
+            m_z[i]                = cos_theta;
+        }
+    }
+
+    // Directions for samples [first, first + count) of a texel; a new rotation is drawn for every pass over the table.
+    void generate(const uint32_t texel, const uint32_t first, const uint32_t count, glm::vec3 *dirs) const {
+        uint32_t  cycle = UINT32_MAX;
+        uint32_t  start = 0;
+        glm::vec3 rot_tan{}, rot_bitan{};
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t sample = first + i;
+            if (sample / SUN_TABLE_SIZE != cycle) {
+                cycle                = sample / SUN_TABLE_SIZE;
+                const Philox4 bits   = philox4x32({texel, cycle, 0, 0}, m_seed, 0x27D4EB2FU);
+                const float   angle  = static_cast<float>(bits[0] >> 8) * 0x1p-24F * 2.0F * 3.14159265F;
+                const float   cos_a  = std::cos(angle);
+                const float   sin_a  = std::sin(angle);
+                rot_tan              = m_tan * cos_a + m_bitan * sin_a;
+                rot_bitan            = m_bitan * cos_a - m_tan * sin_a;
+                start                = bits[1] % SUN_TABLE_SIZE / SUN_TABLE_STRATUM * SUN_TABLE_STRATUM;
+            }
+            const uint32_t entry = (start + sample) % SUN_TABLE_SIZE;
+            dirs[i]              = rot_tan * m_x[entry] + rot_bitan * m_y[entry] + m_axis * m_z[entry];
+        }
+    }
+};
+
+#endif //SUNDISK_H
@@ -0,0 +1,175 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Task = std::function<void(uint32_t worker)>;
+
+class TaskGroup final {
+    std::atomic<uint32_t> m_pending = 0;
+
+    friend class ThreadPool;
+
+public:
+    [[nodiscard]] bool done() const {
+        return m_pending.load(std::memory_order_acquire) == 0;
+    }
+};
+
+/*
+ * Work-stealing pool. Every worker owns a deque: it pops its own work LIFO and steals from the others FIFO.
+ * Worker 0 is the thread that waits on a group, so a pool of one thread runs everything inline.
+ */
+class ThreadPool final {
+    struct Job final {
+        Task       task;
+        TaskGroup *group = nullptr;
+    };
+
+    struct Queue final {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread>            m_threads;
+    std::atomic<uint32_t>               m_queued = 0;
+    std::mutex                          m_wake_mutex;
+    std::condition_variable             m_wake;
+    bool                                m_stop = false;
+
+    static uint32_t &current_worker() {
+        thread_local uint32_t worker = 0;
+        return worker;
+    }
+
+    bool try_pop(const uint32_t worker, Job &job) {
+        {
+            auto &          own = *m_queues[worker];
+            std::lock_guard lock(own.mutex);
+            if (!own.jobs.empty()) {
+                job = std::move(own.jobs.back());
+                own.jobs.pop_back();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        for (uint32_t i = 1; i < size(); ++i) {
+            auto &          victim = *m_queues[(worker + i) % size()];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void execute(const uint32_t worker, Job &job) {
+        job.task(worker);
+        job.group->m_pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    void worker_loop(const uint32_t worker) {
+        current_worker() = worker;
+        Job job;
+        while (true) {
+            if (try_pop(worker, job)) {
+                execute(worker, job);
+                continue;
+            }
+            std::unique_lock lock(m_wake_mutex);
+            m_wake.wait(lock, [this] {
+                return m_stop || m_queued.load(std::memory_order_relaxed) > 0;
+            });
+            if (m_stop) {
+                return;
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(uint32_t thread_count = 0) {
+        if (thread_count == 0) {
+            thread_count = std::max(1U, std::thread::hardware_concurrency());
+        }
+        for (uint32_t worker = 0; worker < thread_count; ++worker) {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+        for (uint32_t worker = 1; worker < thread_count; ++worker) {
+            m_threads.emplace_back(&ThreadPool::worker_loop, this, worker);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(m_wake_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto &thread: m_threads) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool &)            = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    [[nodiscard]] uint32_t size() const {
+        return static_cast<uint32_t>(m_queues.size());
+    }
+
+    void run(TaskGroup &group, Task task) {
+        group.m_pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            auto &          own = *m_queues[current_worker()];
+            std::lock_guard lock(own.mutex);
+            own.jobs.push_back(Job{std::move(task), &group});
+        }
+        m_queued.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard lock(m_wake_mutex);
+        }
+        m_wake.notify_one();
+    }
+
+    void wait(TaskGroup &group) {
+        const uint32_t worker = current_worker();
+        Job            job;
+        while (!group.done()) {
+            if (try_pop(worker, job)) {
+                execute(worker, job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template<typename Fn>
+    void parallel_for(const uint32_t count, const uint32_t grain, const Fn &fn) {
+        TaskGroup group;
+        for (uint32_t begin = 0; begin < count; begin += std::max(grain, 1U)) {
+            const uint32_t end = std::min(count, begin + std::max(grain, 1U));
+            run(group, [&fn, begin, end](const uint32_t worker) {
+                fn(begin, end, worker);
+            });
+        }
+        wait(group);
+    }
+};
+
+#endif //THREADPOOL_H
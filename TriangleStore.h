@@ -0,0 +1,73 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef TRIANGLESTORE_H
+#define TRIANGLESTORE_H
+#include <cstdint>
+#include <vector>
+
+#include "MeshData.h"
+#include "OctNormal.h"
+#include "ThreadPool.h"
+#include "UvRasterizer.h"
+
+#define TRIANGLE_STORE_GRAIN 4096
+
+/*
+ * Per-triangle inputs of patch generation, one array per attribute: UV edge functions already set up in lightmap
+ * texel space and packed face normals. Positions stay in the MeshData. The store is only needed until the
+ * patches exist, so the scene builds it on the stack and drops it before baking.
+ */
+class TriangleStore final {
+    std::vector<UvRasterizer> m_rasterizers;
+    std::vector<uint32_t>     m_normals;
+
+public:
+    TriangleStore(
+        const MeshData &mesh,
+        const uint32_t  width,
+        const uint32_t  height,
+        const bool      conservative,
+        ThreadPool &    pool) {
+        const auto &vertices = mesh.vertices;
+        const auto &uvs      = mesh.lightmap_uvs;
+        const auto &indices  = mesh.indices;
+        const auto  count    = mesh.triangle_count();
+
+        m_rasterizers.resize(count);
+        m_normals.resize(count);
+        pool.parallel_for(count, TRIANGLE_STORE_GRAIN, [&](const uint32_t begin, const uint32_t end, uint32_t) {
+            for (uint32_t ti = begin; ti < end; ++ti) {
+                glm::vec3 positions[3];
+                glm::vec2 tex_coords[3];
+                for (uint32_t corner = 0; corner < 3; ++corner) {
+                    const uint32_t vertex = indices[ti * 3 + corner];
+                    positions[corner]     = {vertices[vertex * 3], vertices[vertex * 3 + 1], vertices[vertex * 3 + 2]};
+                    tex_coords[corner]    = {uvs[vertex * 2], uvs[vertex * 2 + 1]};
+                }
+                m_rasterizers[ti] = UvRasterizer(tex_coords[0], tex_coords[1], tex_coords[2], width, height,
+                                                 conservative);
+                m_normals[ti] = pack_normal(normalize(cross(positions[1] - positions[0], positions[2] - positions[0])));
+            }
+        });
+    }
+
+    [[nodiscard]] uint32_t size() const {
+        return static_cast<uint32_t>(m_normals.size());
+    }
+
+    [[nodiscard]] const UvRasterizer &rasterizer(const uint32_t triangle) const {
+        return m_rasterizers[triangle];
+    }
+
+    [[nodiscard]] uint32_t normal(const uint32_t triangle) const {
+        return m_normals[triangle];
+    }
+
+    [[nodiscard]] size_t memory_bytes() const {
+        return m_rasterizers.capacity() * sizeof(UvRasterizer) + m_normals.capacity() * sizeof(uint32_t);
+    }
+};
+
+#endif //TRIANGLESTORE_H
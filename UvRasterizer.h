@@ -0,0 +1,122 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef UVRASTERIZER_H
+#define UVRASTERIZER_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <glm.hpp>
+
+#define RASTER_LANES 8
+
+/*
+ * Edge-function rasterizer for a triangle in lightmap texel space. Texels are tested RASTER_LANES at a time in
+ * fixed-width lane loops, which the compiler turns into one SSE/AVX compare per edge.
+ *
+ * With conservative set a texel is covered if its square overlaps the triangle, otherwise only if its centre is
+ * inside (edges inclusive). emit(x, y, barycentric, depth) receives weights for the three corners, clamped onto
+ * the triangle for texels whose centre lies outside it, and the smallest unclamped weight: how far inside the
+ * triangle the texel centre is, negative when it is outside.
+ */
+class UvRasterizer final {
+    float      m_edge_x[3]{}, m_edge_y[3]{}, m_edge_c[3]{}, m_slack[3]{};
+    float      m_inv_area = 0.0F;
+    glm::ivec2 m_min{0}, m_max{-1};
+
+public:
+    UvRasterizer() = default; // covers nothing
+
+    UvRasterizer(
+        const glm::vec2 &a,
+        const glm::vec2 &b,
+        const glm::vec2 &c,
+        const uint32_t   width,
+        const uint32_t   height,
+        const bool       conservative) {
+        const glm::vec2 scale = {static_cast<float>(width), static_cast<float>(height)};
+        const glm::vec2 p[3]  = {a * scale, b * scale, c * scale};
+
+        const float area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[1].y - p[0].y) * (p[2].x - p[0].x);
+        if (area == 0.0F || !std::isfinite(area)) {
+            return;
+        }
+        // Flip the edges of clockwise triangles so inside is always non-negative.
+        const float sign = area > 0.0F ? 1.0F : -1.0F;
+        m_inv_area       = 1.0F / std::abs(area);
+
+        // Edge e is opposite corner e, so its value at a point is that corner's unnormalised barycentric weight.
+        for (uint32_t e = 0; e < 3; ++e) {
+            const glm::vec2 &from = p[(e + 1) % 3];
+            const glm::vec2 &to   = p[(e + 2) % 3];
+            m_edge_x[e]           = -(to.y - from.y) * sign;
+            m_edge_y[e]           = (to.x - from.x) * sign;
+            m_edge_c[e]           = -(m_edge_x[e] * from.x + m_edge_y[e] * from.y);
+            // Largest gain of the edge function across half a texel: testing the centre plus this is
+            // testing the texel's corner that lies furthest inside the edge.
+            m_slack[e] = conservative ? (std::abs(m_edge_x[e]) + std::abs(m_edge_y[e])) * 0.5F : 0.0F;
+        }
+
+        const glm::vec2 lo = min(p[0], min(p[1], p[2]));
+        const glm::vec2 hi = max(p[0], max(p[1], p[2]));
+        m_min              = {
+            std::max(0, static_cast<int32_t>(std::floor(lo.x)) - 1),
+            std::max(0, static_cast<int32_t>(std::floor(lo.y)) - 1)
+        };
+        m_max = {
+            std::min(static_cast<int32_t>(width) - 1, static_cast<int32_t>(std::floor(hi.x))),
+            std::min(static_cast<int32_t>(height) - 1, static_cast<int32_t>(std::floor(hi.y)))
+        };
+    }
+
+    template<typename Fn>
+    void rasterize(const Fn &emit) const {
+        for (int32_t y = m_min.y; y <= m_max.y; ++y) {
+            const float py = static_cast<float>(y) + 0.5F;
+            float       row[3];
+            for (uint32_t e = 0; e < 3; ++e) {
+                row[e] = m_edge_y[e] * py + m_edge_c[e];
+            }
+
+            for (int32_t x0 = m_min.x; x0 <= m_max.x; x0 += RASTER_LANES) {
+                alignas(32) float   weights[3][RASTER_LANES];
+                alignas(32) int32_t covered[RASTER_LANES];
+                for (uint32_t lane = 0; lane < RASTER_LANES; ++lane) {
+                    const float px = static_cast<float>(x0 + static_cast<int32_t>(lane)) + 0.5F;
+                    covered[lane]  = x0 + static_cast<int32_t>(lane) <= m_max.x ? 1 : 0;
+                    for (uint32_t e = 0; e < 3; ++e) {
+                        weights[e][lane] = m_edge_x[e] * px + row[e];
+                        covered[lane] &= weights[e][lane] + m_slack[e] >= 0.0F ? 1 : 0;
+                    }
+                }
+
+                for (uint32_t lane = 0; lane < RASTER_LANES; ++lane) {
+                    if (covered[lane] == 0) {
+                        continue;
+                    }
+                    const float depth = std::min(weights[0][lane], std::min(weights[1][lane], weights[2][lane])) *
+                                        m_inv_area;
+                    glm::vec3 barycentric = {
+                        std::max(weights[0][lane], 0.0F),
+                        std::max(weights[1][lane], 0.0F),
+                        std::max(weights[2][lane], 0.0F)
+                    };
+                    barycentric /= barycentric.x + barycentric.y + barycentric.z;
+                    emit(x0 + static_cast<int32_t>(lane), y, barycentric, depth);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] uint32_t count() const {
+        uint32_t covered = 0;
+        rasterize([&covered](int32_t, int32_t, const glm::vec3 &, float) {
+            ++covered;
+        });
+        return covered;
+    }
+};
+
+#endif //UVRASTERIZER_H
@@ -0,0 +1,235 @@
+//
+// Created on 17.10.2026.
+//
+
+#ifndef VISIBILITY_H
+#define VISIBILITY_H
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+#include <embree4/rtcore.h>
+#include <glm.hpp>
+
+#define RAY_PACKET_SIZE   16
+#define SHADOW_CACHE_SIZE 64
+#define HIT_MARGIN        1e-4F
+
+template<uint32_t N>
+struct PacketTraits;
+
+template<>
+struct PacketTraits<4> final {
+    using Ray = RTCRay4;
+
+    static void occluded(const int32_t *valid, const RTCScene scene, Ray *rays, RTCOccludedArguments *args) {
+        rtcOccluded4(valid, scene, rays, args);
+    }
+};
+
+template<>
+struct PacketTraits<8> final {
+    using Ray = RTCRay8;
+
+    static void occluded(const int32_t *valid, const RTCScene scene, Ray *rays, RTCOccludedArguments *args) {
+        rtcOccluded8(valid, scene, rays, args);
+    }
+};
+
+template<>
+struct PacketTraits<16> final {
+    using Ray = RTCRay16;
+
+    static void occluded(const int32_t *valid, const RTCScene scene, Ray *rays, RTCOccludedArguments *args) {
+        rtcOccluded16(valid, scene, rays, args);
+    }
+};
+
+/*
+ * Collects visibility rays into an Embree packet. Occlusion queries are any-hit, so traversal stops at the
+ * first primitive found and no hit record is written back.
+ */
+template<uint32_t N = RAY_PACKET_SIZE>
+class OcclusionPacket final {
+    using Traits = PacketTraits<N>;
+
+    typename Traits::Ray m_rays{};
+    alignas(64) int32_t  m_valid[N]{};
+    uint32_t             m_count = 0;
+
+public:
+    [[nodiscard]] uint32_t count() const {
+        return m_count;
+    }
+
+    [[nodiscard]] bool full() const {
+        return m_count == N;
+    }
+
+    [[nodiscard]] bool occluded(const uint32_t lane) const {
+        return m_rays.tfar[lane] < 0.0F;
+    }
+
+    void push(const glm::vec3 &ray_origin, const glm::vec3 &ray_dir, const float tmin, const float tmax) {
+        const uint32_t lane = m_count++;
+        m_rays.org_x[lane]  = ray_origin.x;
+        m_rays.org_y[lane]  = ray_origin.y;
+        m_rays.org_z[lane]  = ray_origin.z;
+        m_rays.dir_x[lane]  = ray_dir.x;
+        m_rays.dir_y[lane]  = ray_dir.y;
+        m_rays.dir_z[lane]  = ray_dir.z;
+        m_rays.tnear[lane]  = tmin;
+        m_rays.tfar[lane]   = tmax;
+        m_rays.time[lane]   = 0.0F;
+        m_rays.mask[lane]   = 0xFFFFFFFF;
+        m_rays.id[lane]     = lane;
+        m_rays.flags[lane]  = 0;
+        m_valid[lane]       = -1;
+    }
+
+    uint32_t trace(const RTCScene scene, RTCOccludedArguments *args) {
+        for (uint32_t lane = m_count; lane < N; ++lane) {
+            m_valid[lane] = 0;
+        }
+        Traits::occluded(m_valid, scene, &m_rays, args);
+
+        uint32_t occluded_num = 0;
+        for (uint32_t lane = 0; lane < m_count; ++lane) {
+            occluded_num += occluded(lane) ? 1 : 0;
+        }
+        return occluded_num;
+    }
+
+    void clear() {
+        m_count = 0;
+    }
+};
+
+struct ShadowCacheEntry final {
+    uint32_t chart = RTC_INVALID_GEOMETRY_ID;
+    uint32_t prim  = RTC_INVALID_GEOMETRY_ID;
+};
+
+// Last occluding primitive per chart, direct-mapped by chart id.
+using ShadowCache = std::array<ShadowCacheEntry, SHADOW_CACHE_SIZE>;
+
+// Extends the query context so the occlusion filter can report which primitive stopped the ray.
+struct OccluderContext final {
+    RTCRayQueryContext context;
+    uint32_t           prim = RTC_INVALID_GEOMETRY_ID;
+};
+
+inline void record_occluder(const RTCFilterFunctionNArguments *args) {
+    auto *occluder_context = reinterpret_cast<OccluderContext *>(args->context);
+    for (uint32_t lane = 0; lane < args->N; ++lane) {
+        if (args->valid[lane] != 0) {
+            occluder_context->prim = RTCHitN_primID(args->hit, args->N, lane);
+        }
+    }
+}
+
+/*
+ * Moller-Trumbore, two-sided and conservative: it only reports rays that pass through the triangle's interior with
+ * a margin of HIT_MARGIN in barycentrics and in relative distance. Rays grazing an edge, a vertex or the ends of
+ * [tmin, tmax] count as misses, so a caller that falls back to Embree on a miss gets Embree's answer for every
+ * borderline ray. The parallel test is relative to the edge lengths, which keeps it independent of mesh scale.
+ */
+inline bool intersects_triangle(
+    const glm::vec3 &ray_origin,
+    const glm::vec3 &ray_dir,
+    const glm::vec3 &a,
+    const glm::vec3 &b,
+    const glm::vec3 &c,
+    const float      tmin,
+    const float      tmax) {
+    const glm::vec3 ab  = b - a;
+    const glm::vec3 ac  = c - a;
+    const glm::vec3 p   = cross(ray_dir, ac);
+    const float     det = dot(ab, p);
+    if (std::abs(det) <= HIT_MARGIN * length(ab) * length(ac) * length(ray_dir)) {
+        return false;
+    }
+    const float     inv_det = 1.0F / det;
+    const glm::vec3 ao      = ray_origin - a;
+    const float     u       = dot(ao, p) * inv_det;
+    if (u < HIT_MARGIN || u > 1.0F - HIT_MARGIN) {
+        return false;
+    }
+    const glm::vec3 q = cross(ao, ab);
+    const float     v = dot(ray_dir, q) * inv_det;
+    if (v < HIT_MARGIN || u + v > 1.0F - HIT_MARGIN) {
+        return false;
+    }
+    const float t      = dot(ac, q) * inv_det;
+    const float margin = HIT_MARGIN * std::max(t, 1.0F);
+    return t > tmin + margin && t < tmax - margin;
+}
+
+// Closest point on triangle abc to p (Ericson, Real-Time Collision Detection 5.1.5).
+inline glm::vec3 closest_point_on_triangle(
+    const glm::vec3 &p,
+    const glm::vec3 &a,
+    const glm::vec3 &b,
+    const glm::vec3 &c) {
+    const glm::vec3 ab = b - a;
+    const glm::vec3 ac = c - a;
+    const glm::vec3 ap = p - a;
+    const float     d1 = dot(ab, ap);
+    const float     d2 = dot(ac, ap);
+    if (d1 <= 0.0F && d2 <= 0.0F) {
+        return a;
+    }
+
+    const glm::vec3 bp = p - b;
+    const float     d3 = dot(ab, bp);
+    const float     d4 = dot(ac, bp);
+    if (d3 >= 0.0F && d4 <= d3) {
+        return b;
+    }
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0F && d1 >= 0.0F && d3 <= 0.0F) {
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    const glm::vec3 cp = p - c;
+    const float     d5 = dot(ab, cp);
+    const float     d6 = dot(ac, cp);
+    if (d6 >= 0.0F && d5 <= d6) {
+        return c;
+    }
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0F && d2 >= 0.0F && d6 <= 0.0F) {
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0F && d4 - d3 >= 0.0F && d5 - d6 >= 0.0F) {
+        return b + (c - b) * ((d4 - d3) / (d4 - d3 + (d5 - d6)));
+    }
+
+    const float denom = 1.0F / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Distance along the ray to where it leaves the box; the origin must be inside.
+inline float exit_distance(
+    const glm::vec3 &ray_origin,
+    const glm::vec3 &ray_dir,
+    const glm::vec3 &bounds_min,
+    const glm::vec3 &bounds_max) {
+    float t = FLT_MAX;
+    for (int32_t axis = 0; axis < 3; ++axis) {
+        if (ray_dir[axis] > 0.0F) {
+            t = std::min(t, (bounds_max[axis] - ray_origin[axis]) / ray_dir[axis]);
+        } else if (ray_dir[axis] < 0.0F) {
+            t = std::min(t, (bounds_min[axis] - ray_origin[axis]) / ray_dir[axis]);
+        }
+    }
+    return std::max(t, 0.0F);
+}
+
+#endif //VISIBILITY_H
@@ -2,14 +2,17 @@
 
 in  	vec3 origin;
 in  	vec2 uv;
+in  	vec2 lightmap_uv;
 
 out 	vec2 f_uv;
+out 	vec2 f_lightmap_uv;
 
 uniform mat4 view_mat;
 uniform mat4 model_mat;
 uniform mat4 proj_mat;
 
 void main(void) {
-    gl_Position = proj_mat * view_mat * model_mat * vec4(origin, 1.0); 
-    f_uv        = uv;
+    gl_Position   = proj_mat * view_mat * model_mat * vec4(origin, 1.0); 
+    f_uv          = uv;
+    f_lightmap_uv = lightmap_uv;
 }
\ No newline at end of file
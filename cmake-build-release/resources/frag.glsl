@@ -1,6 +1,7 @@
 #version 150
 
 in 	vec2 	  f_uv;
+in 	vec2 	  f_lightmap_uv;
 
 out 	vec4 	  out_col;
 
@@ -8,5 +9,5 @@ uniform sampler2D main_tex;
 uniform sampler2D lightmap_tex;
 
 void main(void) {
-   out_col = texture(main_tex, f_uv) * texture(lightmap_tex, f_uv);
+   out_col = texture(main_tex, f_uv) * texture(lightmap_tex, f_lightmap_uv);
 }
\ No newline at end of file
@@ -4,8 +4,11 @@
 
 #include "Camera.h"
 #include "Display.h"
+#include "Mesh.h"
+#include "MeshLoader.h"
 #include "Scene.h"
 #include "Shader.h"
+#include "Texture.h"
 
 #define TITLE                             "Lightmapper Demo"
 #define WIDTH                             800
@@ -13,6 +16,7 @@
 
 #define SHADER_VERTEX_ATTRIB_TITLE        "origin"
 #define SHADER_TEXTURE_COORD_ATTRIB_TITLE "uv"
+#define SHADER_LIGHTMAP_UV_ATTRIB_TITLE   "lightmap_uv"
 #define VIEW_MATRIX_TITLE                 "view_mat"
 #define MODEL_MATRIX_TITLE                "model_mat"
 #define PROJ_MATRIX_TITLE                 "proj_mat"
@@ -33,6 +37,13 @@
 #define GL_CLEAN_UP                       glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); \
                                           glClearColor(1.0F, 1.0F, 1.0F, 1.0F)
 
+#define TEXTURE_PARAMETERS                {                                                   \
+                                              TexParameter{GL_TEXTURE_MIN_FILTER, GL_LINEAR}, \
+                                              TexParameter{GL_TEXTURE_MAG_FILTER, GL_LINEAR}, \
+                                              TexParameter{GL_TEXTURE_WRAP_S, GL_REPEAT},     \
+                                              TexParameter{GL_TEXTURE_WRAP_T, GL_REPEAT}      \
+                                          }
+
 #define SAMPLES_NUM                       256
 
 #define CAMERA_OFFSET                     3.0F
@@ -53,53 +64,6 @@ std::string read_ascii(const std::string &file_name) {
     return buffer.str();
 }
 
-#pragma region [READ_MESH_BINARY]
-template<typename T>
-static T read_data(const char *buffer, int32_t &ptr) {
-    T                data;
-    constexpr size_t size = sizeof(T);
-    std::memcpy(&data, &buffer[ptr], size);
-    ptr += size;
-    return data;
-}
-
-std::unique_ptr<Mesh> load_mesh(const std::string &file_name) {
-    int32_t       ptr = 0;
-    std::ifstream input_stream(file_name, std::ios::binary);
-
-    if (!input_stream) {
-        std::cerr << "Error opening file: " << file_name << std::endl;
-        return nullptr;
-    }
-
-    input_stream.seekg(0, std::ios::end);
-    const long long size = input_stream.tellg();
-    input_stream.seekg(0, std::ios::beg);
-
-    const auto buffer = new char[size];
-    input_stream.read(buffer, static_cast<int32_t>(size));
-    input_stream.close();
-
-    const auto vertex_count = read_data<int32_t>(buffer, ptr);
-    const auto index_count  = read_data<int32_t>(buffer, ptr);
-
-    std::vector<float>    vertices;
-    std::vector<float>    tex_coords;
-    std::vector<uint32_t> indices;
-
-    for (int32_t i = 0; i < vertex_count * 3; ++i) vertices.push_back(read_data<float>(buffer, ptr));
-    for (int32_t i = 0; i < vertex_count * 2; ++i) tex_coords.push_back(read_data<float>(buffer, ptr));
-    for (int32_t i = 0; i < index_count; ++i) indices.push_back(read_data<uint32_t>(buffer, ptr));
-
-    auto mesh = std::make_unique<Mesh>();
-    mesh->set_vertices(vertices);
-    mesh->set_tex_coords(tex_coords);
-    mesh->set_indices(indices);
-
-    delete[] buffer;
-    return mesh;
-}
-#pragma endregion
 
 int main() {
     const auto display = new Display(TITLE, WIDTH, HEIGHT, 3, 3);
@@ -115,19 +79,26 @@ int main() {
         .name = SHADER_TEXTURE_COORD_ATTRIB_TITLE
     };
 
+    const ShaderAttrib shader_lightmap_uv_attrib{
+        .location = GL_LIGHTMAP_COORD_ATTRIB_ARRAY,
+        .name = SHADER_LIGHTMAP_UV_ATTRIB_TITLE
+    };
+
     const auto shader = new Shader(read_ascii(VERTEX_SHADER_FILEPATH),
                                    read_ascii(FRAGMENT_SHADER_FILEPATH),
                                    shader_vertex_attrib,
-                                   shader_uv_attrib);
+                                   shader_uv_attrib,
+                                   shader_lightmap_uv_attrib);
 
-    const auto  mesh            = load_mesh(MESH_FILENAME);
-    const auto &mesh_bounds_min = mesh->min;
-    const auto &mesh_bounds_max = mesh->max;
+    const auto  mesh_data       = load_mesh(MESH_FILENAME);
+    const auto &mesh_bounds_min = mesh_data->min;
+    const auto &mesh_bounds_max = mesh_data->max;
+    const auto  mesh            = std::make_unique<Mesh>(*mesh_data);
 
     const auto cam = new Camera(glm::radians(CAMERA_FOV), static_cast<float>(WIDTH) / HEIGHT);
     cam->location  = {0.0F, (mesh_bounds_min.y + mesh_bounds_max.y) * 0.5F, mesh_bounds_max.z + CAMERA_OFFSET};
 
-    const auto    scene              = new Scene(glm::vec3{LIGHT_DIRECTION}, mesh.get(), SAMPLES_NUM);
+    const auto    scene              = new Scene(glm::vec3{LIGHT_DIRECTION}, mesh_data.get(), SAMPLES_NUM);
     const int32_t view_mat_location  = shader->get_uniform_location(VIEW_MATRIX_TITLE);
     const int32_t model_mat_location = shader->get_uniform_location(MODEL_MATRIX_TITLE);
     const int32_t proj_mat_location  = shader->get_uniform_location(PROJ_MATRIX_TITLE);
@@ -135,15 +106,19 @@ int main() {
     const int32_t albedo_location = shader->get_uniform_location(ALBEDO_MAP_TITLE);
     const int32_t lightmap_location     = shader->get_uniform_location(LIGHT_MAP_TITLE);
 
-    scene->load_albedo_from_file(ALBEDO_TEXTURE_FILENAME);
+    const auto albedo_texture   = new Texture(LIGHTMAP_SIZE, LIGHTMAP_SIZE, TEXTURE_PARAMETERS, COLOR_WHITE,
+                                              ImageBuffering::Single);
+    const auto lightmap_texture = new Texture(LIGHTMAP_SIZE, LIGHTMAP_SIZE, TEXTURE_PARAMETERS);
+    albedo_texture->load(ALBEDO_TEXTURE_FILENAME);
+
+    scene->bake();
+    *lightmap_texture = scene->lightmap;
 
     Texture::active(0);
-    scene->albedo_texture.bind();
+    albedo_texture->bind();
 
     Texture::active(1);
-    scene->lightmap_texture.bind();
-
-    scene->bake();
+    lightmap_texture->bind();
 
     float angle = 0.0F;
     while (display->running) {
@@ -168,6 +143,8 @@ int main() {
     }
 
     delete cam;
+    delete lightmap_texture;
+    delete albedo_texture;
     delete scene;
     delete shader;
     delete display;
@@ -0,0 +1,51 @@
+//
+// Created on 17.10.2026.
+//
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+#include "AccumulationBuffer.h"
+
+#define TRIALS          20000
+#define UNIT_VARIANCE   0.01F
+#define TRUE_MEAN       0.5F
+
+/*
+ * Bakes one texel the way adaptive sampling does: a few unit-weight passes, then passes at a higher ray scale,
+ * each estimate drawn with variance UNIT_VARIANCE / weight. Averaged over many trials, error()^2 has to match the
+ * variance of the weighted mean, UNIT_VARIANCE / total weight.
+ */
+static bool check_mixed_weights(const bool half, const float tolerance) {
+    constexpr uint32_t unit_passes   = 3;
+    constexpr uint32_t scaled_passes = 9;
+    constexpr float    scale         = 4.0F;
+    constexpr float    total_weight  = unit_passes + scaled_passes * scale;
+
+    std::mt19937 rng(1234);
+    double       estimated_variance = 0.0;
+    for (uint32_t trial = 0; trial < TRIALS; ++trial) {
+        AccumulationBuffer buffer(1, 1, half);
+        for (uint32_t pass = 0; pass < unit_passes + scaled_passes; ++pass) {
+            const float                     weight = pass < unit_passes ? 1.0F : scale;
+            std::normal_distribution<float> estimate(TRUE_MEAN, std::sqrt(UNIT_VARIANCE / weight));
+            buffer.add(0, estimate(rng), weight);
+        }
+        estimated_variance += static_cast<double>(buffer.error(0)) * buffer.error(0);
+    }
+    estimated_variance /= TRIALS;
+
+    const double true_variance = UNIT_VARIANCE / total_weight;
+    const double ratio         = estimated_variance / true_variance;
+    std::cout << (half ? "half" : "full") << " precision: estimated " << estimated_variance << ", true "
+              << true_variance << ", ratio " << ratio << std::endl;
+    return std::abs(ratio - 1.0) <= tolerance;
+}
+
+int main() {
+    bool passed = check_mixed_weights(false, 0.05);
+    passed      = check_mixed_weights(true, 0.05) && passed;
+    return passed ? 0 : 1;
+}